@@ -9,15 +9,13 @@
 
 #include "Logger.h"
 #include "Monomorphizer.h"
+#include "TokenTable.h"
 
 // Hoisting
 void BlockAST::prePass(SymbolTable &table) {
     for (auto& stmt : statements) {
-        if (auto* funcDef = dynamic_cast<FunctionDefinitionAST*>(stmt.get())) {
-            funcDef->prePass(table);
-        }
-        if (auto* structDef = dynamic_cast<StructDefinitionAST*>(stmt.get())) {
-           structDef->prePass(table);
+        if (stmt->kind == ASTKind::FunctionDefinition || stmt->kind == ASTKind::StructDefinition) {
+            stmt->prePass(table);
         }
     }
 }
@@ -31,87 +29,107 @@ void BlockAST::analyse(SymbolTable &table) {
     table.exitScope();
 }
 
-string BlockAST::code() {
-    string code = "{\n";
+void BlockAST::declare(SymbolTable& table) {
     for (const auto& stmt : statements) {
-        code += '\t' + stmt->code() + ";\n";
+        if (isa<StructDefinitionAST>(stmt.get())) {
+            stmt->analyse(table); // Fields and default constructor, no body to analyse
+        } else if (const auto extends = ast_cast<ExtendsStatementAST>(stmt.get())) {
+            extends->declare(table);
+        }
     }
-    code += "}\n";
-    return code;
+}
+
+void BlockAST::emit(CodeEmitter& out) {
+    out << "{\n";
+    out.indent();
+    for (const auto& stmt : statements) {
+        out.tab();
+        stmt->emit(out);
+        out << ";\n";
+    }
+    out.dedent();
+    out.tab() << "}\n";
 }
 
 void ExprAST::prePass(SymbolTable &table) {
     AST::prePass(table);
 }
 
-void FloatExprAST::analyse(SymbolTable &table, string &a) {
-    a = "float";
+void FloatExprAST::analyse(SymbolTable &table, TypeId &a) {
+    a = TypeTable::Float;
 }
 
-string FloatExprAST::code() {
-    return to_string(val) + "f";
+void FloatExprAST::emit(CodeEmitter& out) {
+    out << to_string(val) << 'f';
 }
 
-void IntExprAST::analyse(SymbolTable &table, string &a) {
-    a = "int";
+void IntExprAST::analyse(SymbolTable &table, TypeId &a) {
+    a = TypeTable::Int;
 }
 
-string IntExprAST::code() {
-    return to_string(val);
+void IntExprAST::emit(CodeEmitter& out) {
+    out << val;
 }
 
-void StringExprAST::analyse(SymbolTable &table, string &a) {
-    a = "string";
+void StringExprAST::analyse(SymbolTable &table, TypeId &a) {
+    a = TypeTable::String;
 }
 
-string StringExprAST::code() {
-    return '"' + val + '"';
+void StringExprAST::emit(CodeEmitter& out) {
+    out << '"' << val << '"';
 }
 
-void VariableExprAST::analyse(SymbolTable &table, string &a) {
-    if (const auto symbol = table.lookupSymbol(name)) {
-        a = symbol->type;
+void VariableExprAST::analyse(SymbolTable &table, TypeId &a) {
+    if (!binding) {
+        binding = table.lookupSymbol(name);
+    }
+    if (binding) {
+        a = binding->type;
         isField = false;
         return;
     }
     Logger::Error("Variable '" + name + "' not declared.");
-    a = "error_type";
+    a = TypeTable::Error;
 }
 
 
-string VariableExprAST::code() {
+void VariableExprAST::emit(CodeEmitter& out) {
     if (isField) {
-        return "self->" + name;
+        out << "self->" << name;
+        return;
     }
     if (name == "this") {
-        return "self";
+        out << "self";
+        return;
     }
-    return name;
+    out << name;
 }
 
-void OperationExprAST::analyse(SymbolTable &table, string &a) {
-    string lhsType;
-    string rhsType;
+void OperationExprAST::analyse(SymbolTable &table, TypeId &a) {
+    TypeId lhsType;
+    TypeId rhsType;
     LHS->analyse(table, lhsType);
     RHS->analyse(table, rhsType);
 
     if (lhsType != rhsType) {
-        Logger::Error("Type mismatch in operation. LHS is '" + lhsType + "', RHS is '" + rhsType + "'.");
-        a = "error_type";
+        Logger::Error("Type mismatch in operation. LHS is '" + lhsType.name() + "', RHS is '" + rhsType.name() + "'.");
+        a = TypeTable::Error;
     }
     a = lhsType;
 }
 
 // REWORK
-string OperationExprAST::code() {
-    string ope = tokenToString(op);
-    return LHS->code() + ' ' + ope + ' ' + RHS->code();
+void OperationExprAST::emit(CodeEmitter& out) {
+    LHS->emit(out);
+    out << ' ' << tokenInfo(op).spelling << ' ';
+    RHS->emit(out);
 }
 
 // REWORK : maybe add other primitives
-bool isPrimitive(const string& type) {
-    const set<string> primitives = {"int", "float", "double", "bool", "void"};
-    return primitives.contains(type);
+bool isPrimitive(const TypeId type) {
+    static const TypeId doubleType = TypeTable::Global().intern("double");
+    static const TypeId boolType = TypeTable::Global().intern("bool");
+    return type == TypeTable::Int || type == TypeTable::Float || type == doubleType || type == boolType || type == TypeTable::Void;
 }
 
 void TypeAST::analyse(SymbolTable &table) {
@@ -125,21 +143,56 @@ void TypeAST::analyse(SymbolTable &table) {
     }
 }
 
-string TypeAST::code() {
-    if (isPrimitive(type)) {
-        return type;
+string TypeAST::source() const {
+    if (genericArgs.empty()) return type;
+    string text = type + '<';
+    for (size_t i = 0; i < genericArgs.size(); i++) {
+        if (i > 0) text += ", ";
+        text += genericArgs[i]->source();
+    }
+    // Nested arguments are closed with "> >", the lexer reads ">>" as a shift
+    return text + (text.back() == '>' ? " >" : ">");
+}
+
+void TypeAST::emit(CodeEmitter& out) {
+    // An instantiated type is the structure generated under its mangled name
+    out << (genericArgs.empty() ? type : getMangledName());
+    if (!isPrimitive(id())) {
+        out << '*';
+    }
+}
+
+
+void FunctionParameterAST::emit(CodeEmitter& out) {
+    type->emit(out);
+    out << ' ' << name;
+}
+
+// Parameter types as matched against the arguments of a call
+static vector<TypeId> parameterTypes(const vector<unique_ptr<FunctionParameterAST>>& params) {
+    vector<TypeId> types;
+    types.reserve(params.size());
+    for (const auto& param : params) {
+        types.push_back(TypeTable::Global().intern(param->type->type));
     }
-    return type + "*";
+    return types;
 }
 
+// Signature of a call that matched no overload, for the diagnostics
+static string callSignature(string signature, const span<const TypeId> args) {
+    for (const TypeId arg : args) {
+        signature += '_' + arg.name();
+    }
+    return signature;
+}
 
-string FunctionParameterAST::code() {
-    return type->code() + ' ' + name;
+Overload FunctionDefinitionAST::overload() {
+    return {parameterTypes(params), {.type = TypeTable::Global().intern(returnType->type), .declaration = this}, getSignature()};
 }
 
 void FunctionDefinitionAST::prePass(SymbolTable &table) {
-    if (const string signature = getSignature(); !table.addSymbol(signature, {returnType->type})) {
-        Logger::Error("Function '" + name + "' already defined. (signature : "+signature+").");
+    if (!table.addOverload(TypeTable::None, NameTable::Global().intern(name), overload())) {
+        Logger::Error("Function '" + name + "' already defined. (signature : "+getSignature()+").");
     }
 }
 
@@ -148,85 +201,84 @@ void FunctionDefinitionAST::analyse(SymbolTable &table) {
 }
 
 void FunctionDefinitionAST::analyse(SymbolTable& table, const string& parentStruct) {
-    if (!table.addSymbol(getSignature(), {returnType->type})) {
-        Logger::Error("Function '" + name + "' already defined. (signature : " + getSignature() + ")");
-    }
+    TypeTable& types = TypeTable::Global();
+    const TypeId declaredType = types.intern(returnType->type);
     table.enterScope();
 
-    const string concreteReturnType = ensureTypeIsInstantiated(returnType.get(), table);
-    if (concreteReturnType == "error_type") {
+    const TypeId concreteReturnType = ensureTypeIsInstantiated(returnType.get(), table);
+    if (concreteReturnType == TypeTable::Error) {
         Logger::Error("Error while encoutering generics in function '" + name + "'.");
         return;
     }
 
     if (!parentStruct.empty()) {
-        table.addSymbol("this", {parentStruct + "*", SymbolInfo::Variable});
+        table.addSymbol("this", {types.pointerTo(types.intern(parentStruct)), SymbolInfo::Variable});
     }
 
     for (const auto& param : params) {
-        string concreteParamType = ensureTypeIsInstantiated(param->type.get(), table);
-        if (concreteParamType == "error_type") continue;
+        const TypeId concreteParamType = ensureTypeIsInstantiated(param->type.get(), table);
+        if (concreteParamType == TypeTable::Error) continue;
 
-        if (!table.addSymbol(param->name, {concreteParamType, SymbolInfo::Variable})) {
+        if (!table.addSymbol(param->name, {.type = concreteParamType, .metaType = SymbolInfo::Variable, .declaration = param.get()})) {
             Logger::Error("Parameter '" + param->name + "' already defined in function '" + name + "'.");
         }
     }
 
     // Lookup for the return type of the function
-    string type;
-    if (const auto assignment = dynamic_cast<ExprAST*>(body.get())) {
+    TypeId type;
+    if (const auto assignment = ast_cast<ExprAST>(body.get())) {
         assignment->analyse(table, type);
-        if (type != returnType->type) {
-            Logger::Error("Invalid return type, expected '"+returnType->type+"' but found '"+type+"'.");
+        if (type != declaredType) {
+            Logger::Error("Invalid return type, expected '"+returnType->type+"' but found '"+type.name()+"'.");
         }
     }
-    else if (const auto block = dynamic_cast<BlockAST*>(body.get())) {
+    else if (const auto block = ast_cast<BlockAST>(body.get())) {
         for (const auto& stmt : block->statements) {
-            if (const auto ret = dynamic_cast<ReturnAST*>(stmt.get())) {
+            if (const auto ret = ast_cast<ReturnAST>(stmt.get())) {
                 if (ret->value != nullptr) {
                     auto* value = ret->value.get();
                     value->analyse(table, type);
                 }
                 // Void function case
-                if (returnType->type == "void") {
-                    if (type.empty()) {
+                if (declaredType == TypeTable::Void) {
+                    if (type == TypeTable::None) {
                         continue;
                     }
-                    Logger::Error("Can not return '" + type + "' from void function.");
+                    Logger::Error("Can not return '" + type.name() + "' from void function.");
                     continue;
                 }
                 // Non-void function case
-                if (type.empty()) {
+                if (type == TypeTable::None) {
                     Logger::Error("Function should return '" + returnType->type + "'.");
                 }
 
-                if (type != returnType->type) {
+                if (type != declaredType) {
                     Logger::Error("Invalid return type, expected '" + returnType->type +
-                                  "' but found '" + type + "'.");
+                                  "' but found '" + type.name() + "'.");
                 }
 
                 continue;
             }
-            if (auto* assign = dynamic_cast<VariableAssignmentAST*>(stmt.get())) {
-                if (auto* varExpr = dynamic_cast<VariableExprAST*>(assign->target.get())) {
+            if (auto* assign = ast_cast<VariableAssignmentAST>(stmt.get())) {
+                if (auto* varExpr = ast_cast<VariableExprAST>(assign->target.get())) {
                     varExpr->isField = true;
                 }
-                if (auto* varExpr = dynamic_cast<VariableExprAST*>(assign->value.get())) {
+                if (auto* varExpr = ast_cast<VariableExprAST>(assign->value.get())) {
                     varExpr->isField = true;
                 }
-                string tmp;
+                TypeId tmp;
                 assign->analyse(table, tmp);
                 continue; // Continue to the next statement
             }
-            if (const auto expr = dynamic_cast<ExprAST*>(stmt.get())){
-                string tmp;
+            if (const auto expr = ast_cast<ExprAST>(stmt.get())){
+                TypeId tmp;
                 expr->analyse(table, tmp);
             } else {
                 stmt->analyse(table);
             }
         }
     }
-    if (type.empty() && returnType->type != "void") {
+    if (type == TypeTable::None && declaredType != TypeTable::Void) {
         Logger::Error("Missing return statement in function '" + name +"'.");
     }
 
@@ -234,41 +286,52 @@ void FunctionDefinitionAST::analyse(SymbolTable& table, const string& parentStru
     table.exitScope();
 }
 
-string FunctionDefinitionAST::code(bool isMethod) {
-    string code = returnType->code() + ' ' + getSignature() + '(';
+void FunctionDefinitionAST::emit(CodeEmitter& out, const bool isMethod) {
+    returnType->emit(out);
+    out << ' ' << getSignature() << '(';
     if (isMethod) {
-        code += "* self";
+        out << "* self";
         if (!params.empty()) {
-            code += ", ";
+            out << ", ";
         }
     }
     for (const auto& param : params) {
-        code += param->code();
+        param->emit(out);
         if (param != params.back()) {
-            code += ", ";
+            out << ", ";
         }
     }
-    code += ')';
-    if (const auto expr = dynamic_cast<ExprAST*>(body.get())) {
-        code += "{ return "+ expr->code() +"; }";
-    } else if (const auto block = dynamic_cast<BlockAST*>(body.get())) {
+    out << ')';
+    if (const auto expr = ast_cast<ExprAST>(body.get())) {
+        out << "{ return ";
+        expr->emit(out);
+        out << "; }";
+    } else if (const auto block = ast_cast<BlockAST>(body.get())) {
         if (name == "main") {
-            code += "{\n";
-            code += "\tinitGlobalPool(0, 0);";
+            out << "{\n";
+            out.indent();
+            out.tab() << "initGlobalPool(0, 0);";
             for (const auto& stmt : block->statements) {
-                code += '\t' + stmt->code() + ";\n";
+                out.tab();
+                stmt->emit(out);
+                out << ";\n";
             }
-            code += "}\n";
+            out.dedent();
+            out.tab() << "}\n";
         } else {
-            code += block->code();
+            block->emit(out);
         }
     }
+}
 
-    return code;
+void FunctionDefinitionAST::emit(CodeEmitter& out) {
+    emit(out, false);
 }
 
-string FunctionDefinitionAST::code() {
-    return code(false);
+string FunctionDefinitionAST::code(const bool isMethod) {
+    CodeEmitter out;
+    emit(out, isMethod);
+    return out.take();
 }
 
 string FunctionDefinitionAST::getSignature() {
@@ -279,12 +342,13 @@ string FunctionDefinitionAST::getSignature() {
     return signature;
 }
 
-string StructFieldAST::code() {
-    return type->code() + ' ' + name;
+void StructFieldAST::emit(CodeEmitter& out) {
+    type->emit(out);
+    out << ' ' << name;
 }
 
 void StructDefinitionAST::prePass(SymbolTable &table) {
-    if (!table.addSymbol(name, {name, SymbolInfo::Structure})) {
+    if (!table.addSymbol(name, {.type = structType(), .metaType = SymbolInfo::Structure, .declaration = this})) {
         Logger::Error("Structure '" + name + "' already defined.");
     }
 }
@@ -295,34 +359,46 @@ void StructDefinitionAST::analyse(SymbolTable &table) {
         return;
     }
 
+    TypeTable& types = TypeTable::Global();
     table.enterScope();
     string sign;
 
     for (const auto& generic : genericParams) {
-        if (!table.addSymbol(generic->name, {"generic", SymbolInfo::Generic})) {
+        if (!table.addSymbol(generic->name, {TypeTable::Generic, SymbolInfo::Generic})) {
             Logger::Error("Generic parameter '" + generic->name + "' already defined in the current structure '" + name + "'.");
         }
     }
+    // A field of a generic type instantiates it, ex : the 'Box<int>' field of 'Box<Box<int> >'
+    vector<TypeId> fieldTypes;
     for (const auto& field : fields) {
-        if (!table.addSymbol(field->name, {field->type->type, SymbolInfo::Variable})) {
-            Logger::Error("Field '" + field->name + "' already defined in the current structure '" + name + "'.");
+        fieldTypes.push_back(field->type->genericArgs.empty() ? types.intern(field->type->type) : ensureTypeIsInstantiated(field->type.get(), table));
+    }
+    for (size_t i = 0; i < fields.size(); i++) {
+        if (!table.addSymbol(fields[i]->name, {.type = fieldTypes[i], .metaType = SymbolInfo::Variable, .declaration = fields[i].get()})) {
+            Logger::Error("Field '" + fields[i]->name + "' already defined in the current structure '" + name + "'.");
             continue;
         }
-        sign += "_" + field->type->type;
+        sign += "_" + fields[i]->type->type;
     }
     StructFieldMap fieldsMap;
-    for (const auto& field : fields) {
-        fieldsMap[field->name] = {field->type->type, SymbolInfo::Variable};
+    for (size_t i = 0; i < fields.size(); i++) {
+        fieldsMap.emplace_back(NameTable::Global().intern(fields[i]->name), SymbolInfo{.type = fieldTypes[i], .metaType = SymbolInfo::Variable, .declaration = fields[i].get()});
     }
     table.addStruct(name, fieldsMap);
 
     table.exitScope();
-    table.addSymbol("fun_" + name + sign, {name});
+    // Default constructor, generated by the CodeGenerator
+    Overload defaultConstructor{{}, {.type = structType(), .declaration = this}, "fun_" + name + sign};
+    defaultConstructor.params = fieldTypes;
+    table.addOverload(TypeTable::None, NameTable::Global().intern(name), move(defaultConstructor));
 }
 
 void ConstructorDefinitionAST::prePass(SymbolTable &table) {
     // Le constructeur est une fonction qui retourne un pointeur vers la struct
-    if (!table.addSymbol(getSignature(), {structName + "*", SymbolInfo::Function})) {
+    TypeTable& types = TypeTable::Global();
+    const TypeId structType = types.intern(structName);
+    Overload constructor{parameterTypes(params), {.type = types.pointerTo(structType), .metaType = SymbolInfo::Function, .declaration = this}, getSignature()};
+    if (!table.addOverload(structType, NameTable::Empty, move(constructor))) {
         Logger::Error("Constructor for struct '" + structName + "' with this signature already defined.");
     }
 }
@@ -330,7 +406,7 @@ void ConstructorDefinitionAST::prePass(SymbolTable &table) {
 void ConstructorDefinitionAST::analyse(SymbolTable &table) {
     table.enterScope();
     for (const auto& param : params) {
-        table.addSymbol(param->name, {param->type->type, SymbolInfo::Variable});
+        table.addSymbol(param->name, {.type = TypeTable::Global().intern(param->type->type), .metaType = SymbolInfo::Variable, .declaration = param.get()});
     }
     body->analyse(table);
     table.exitScope();
@@ -345,195 +421,223 @@ string ConstructorDefinitionAST::getSignature() {
     return signature;
 }
 
-string ConstructorDefinitionAST::code() {
-    string signature = getSignature();
-    string code = structName + "* " + signature + "(";
+void ConstructorDefinitionAST::emit(CodeEmitter& out) {
+    out << structName << "* " << getSignature() << "(";
     for (const auto& param : params) {
-        code += param->code();
+        param->emit(out);
         if (param != params.back()) {
-            code += ", ";
+            out << ", ";
         }
     }
-    code += ") ";
+    out << ") ";
 
-    string bodyCode = "{\n";
+    out << "{\n";
+    out.indent();
     // Alloc of the struct
-    bodyCode += "\t" + structName + "* self = alloc(sizeof(" + structName + "));\n";
+    out.tab() << structName << "* self = alloc(sizeof(" << structName << "));\n";
 
-    if (const auto block = dynamic_cast<BlockAST*>(body.get())) {
+    if (const auto block = ast_cast<BlockAST>(body.get())) {
         for (const auto& stmt : block->statements) {
-            bodyCode += "\t" + stmt->code();
+            out.tab();
+            stmt->emit(out);
         }
     }
 
-    bodyCode += "\treturn self;\n";
-    bodyCode += "}\n";
+    out.tab() << "return self;\n";
+    out.dedent();
+    out.tab() << "}\n";
+}
 
-    return code + bodyCode;
+static void declareMethod(SymbolTable& table, const string& structName, FunctionDefinitionAST& method) {
+    Overload overload = method.overload();
+    overload.cName = structName + '_' + overload.cName;
+    if (!table.addOverload(TypeTable::Global().intern(structName), NameTable::Global().intern(method.name), move(overload))) {
+        Logger::Error("Method " + method.name + " already defined in struct " + structName + ".");
+    }
 }
 
 void ExtendsStatementAST::analyse(SymbolTable& table) {
     for (auto& member : members) {
-        if (auto* method = dynamic_cast<FunctionDefinitionAST*>(member.get())) {
+        if (auto* method = ast_cast<FunctionDefinitionAST>(member.get())) {
             method->analyse(table, structName);
-            if (!table.addSymbol(structName + '_' + method->getSignature(), {method->returnType->type})) {
-                Logger::Error("Method " + method->name + " already defined in struct " + structName + ".");
-            }
+            declareMethod(table, structName, *method);
         }
         // TODO : else analyse case
     }
 }
 
+void ExtendsStatementAST::declare(SymbolTable& table) {
+    for (auto& member : members) {
+        if (auto* method = ast_cast<FunctionDefinitionAST>(member.get())) {
+            declareMethod(table, structName, *method);
+        }
+    }
+}
+
 bool ExtendsStatementAST::isFieldOnly() {
     for (auto& stmt : members) {
-        if (dynamic_cast<VariableDeclarationAST*>(stmt.get()) == nullptr) {
+        if (stmt->kind != ASTKind::VariableDeclaration) {
             return false;
         }
     }
     return true;
 }
 
-string ReturnAST::code() {
-    if (value == nullptr) return "return";
-    return "return " + value->code();
+void ReturnAST::emit(CodeEmitter& out) {
+    out << "return";
+    if (value != nullptr) {
+        out << ' ';
+        value->emit(out);
+    }
 }
 
-string ExternExprAST::code() {
-    return body;
+void ExternExprAST::emit(CodeEmitter& out) {
+    out << body;
 }
 
-void FunctionCallAST::analyse(SymbolTable &table, string &a) {
+void FunctionCallAST::analyse(SymbolTable &table, TypeId &a) {
+    if (binding) {
+        a = binding->type;
+        return;
+    }
+    vector<TypeId> args;
+    args.reserve(params.size());
+    for (const auto& param : params) {
+        param->analyse(table, args.emplace_back());
+    }
+
     // Check if it's a constructor call
     optional<SymbolInfo> typeInfo = table.lookupSymbol(name);
     if (typeInfo && typeInfo->metaType == SymbolInfo::Structure) {
-        signature = name + "_new";
-        for (const auto& param : params) {
-            string tmp;
-            param->analyse(table, tmp);
-            signature += '_' + tmp;
-        }
-
-        const auto symbol = table.lookupSymbol(signature);
-        if (!symbol || symbol->metaType != SymbolInfo::Function) {
+        const Overload* constructor = table.resolve(typeInfo->type, NameTable::Empty, args);
+        if (!constructor) {
+            signature = callSignature(name + "_new", args);
             Logger::Error("Constructor for '" + name + "' not declared with signature: " + signature);
-            a = "error_type";
+            a = TypeTable::Error;
             return;
         }
-        a = name + "*";
+        signature = constructor->cName;
+        binding = constructor->symbol;
+        a = binding->type;
         return;
     }
 
     // Normal function call
-    string sign = "fun_" + name;
-    for (const auto& param : params) {
-        string tmp;
-        param->analyse(table, tmp);
-        sign += '_' + tmp;
-    }
-    signature = sign;
-
-    const auto symbol = table.lookupSymbol(signature);
-    if (!symbol || symbol->metaType != SymbolInfo::Function) {
+    const auto id = NameTable::Global().find(name);
+    const Overload* function = id ? table.resolve(TypeTable::None, *id, args) : nullptr;
+    if (!function) {
+        signature = callSignature("fun_" + name, args);
         Logger::Error("Function '" + name + "' not declared. (signature : "+signature+").");
-        a = "error_type";
-    } else {
-        a = symbol->type;
+        a = TypeTable::Error;
+        return;
     }
+    signature = function->cName;
+    binding = function->symbol;
+    a = binding->type;
 }
 
-string FunctionCallAST::code() {
-    string code = signature + '(';
+void FunctionCallAST::emit(CodeEmitter& out) {
+    out << signature << '(';
     for (auto& param : params) {
-        code += param->code();
+        param->emit(out);
         if (param != params.back()) {
-            code += ", ";
+            out << ", ";
         }
     }
-    return code + ')';
+    out << ')';
 }
 
 // REWORK : check object
-void MethodCallAST::analyse(SymbolTable &table, string &a) {
+void MethodCallAST::analyse(SymbolTable &table, TypeId &a) {
+    if (binding) {
+        a = binding->type;
+        return;
+    }
     // Analyse the owner type
-    string ownerType;
+    TypeId ownerType;
     ownerExpr->analyse(table, ownerType);
 
-    if (ownerType == "error_type") {
-        a = "error_type";
+    if (ownerType == TypeTable::Error) {
+        a = TypeTable::Error;
         return;
     }
 
     // Extract the type (without the pointer symbol)
-    if (!ownerType.empty() && ownerType.back() == '*') {
-        ownerType.pop_back();
-    }
-    signature = ownerType + "_fun_" + name;
+    ownerType = TypeTable::Global().pointee(ownerType);
+    vector<TypeId> args;
+    args.reserve(params.size());
     for (const auto& param : params) {
-        string tmp;
-        param->analyse(table, tmp);
-        signature += '_' + tmp;
+        param->analyse(table, args.emplace_back());
     }
 
     // Check if the method acually exists
-    const auto symbol = table.lookupSymbol(signature);
-    if (!symbol || symbol->metaType != SymbolInfo::Function) {
+    const auto id = NameTable::Global().find(name);
+    const Overload* method = id ? table.resolve(ownerType, *id, args) : nullptr;
+    if (!method) {
+        signature = callSignature(ownerType.name() + "_fun_" + name, args);
         Logger::Error("Method '" + name + "' not declared. (signature : "+signature+").");
-        a = "error_type";
+        a = TypeTable::Error;
         return;
     }
-    a = symbol->type;
+    signature = method->cName;
+    binding = method->symbol;
+    a = binding->type;
 }
 
-string MethodCallAST::code() {
-    string code = signature + '(' + ownerExpr->code();
+void MethodCallAST::emit(CodeEmitter& out) {
+    out << signature << '(';
+    ownerExpr->emit(out);
     if (!params.empty()) {
-        code += ", ";
+        out << ", ";
     }
     for (auto& param : params) {
-        code += param->code();
+        param->emit(out);
         if (param != params.back()) {
-            code += ", ";
+            out << ", ";
         }
     }
-    return code + ')';
+    out << ')';
 }
 
-void FieldAccessAST::analyse(SymbolTable &table, string &a) {
-    string ownerType;
+void FieldAccessAST::analyse(SymbolTable &table, TypeId &a) {
+    if (binding) {
+        a = binding->type;
+        return;
+    }
+    TypeId ownerType;
     ownerExpr->analyse(table, ownerType);
-    if (ownerType == "error_type") {
-        a = "error_type";
+    if (ownerType == TypeTable::Error) {
+        a = TypeTable::Error;
         return;
     }
 
     // Extract the type (without the pointer symbol)
-    if (!ownerType.empty() && ownerType.back() == '*') {
-        ownerType.pop_back();
-    }
+    ownerType = TypeTable::Global().pointee(ownerType);
 
-    if (const auto fieldSymbol = table.lookupField(ownerType, name)) {
+    if (const auto fieldSymbol = table.lookupField(ownerType.name(), name)) {
+        binding = fieldSymbol;
         a = fieldSymbol->type;
     } else {
-        Logger::Error("Field '" + name + "' does not exist in struct '" + ownerType + "'.");
-        a = "error_type";
+        Logger::Error("Field '" + name + "' does not exist in struct '" + ownerType.name() + "'.");
+        a = TypeTable::Error;
     }
 }
 
 
 
-string FieldAccessAST::code() {
-    string code = ownerExpr->code();
-    return ownerExpr->code() + "->" + name;
+void FieldAccessAST::emit(CodeEmitter& out) {
+    ownerExpr->emit(out);
+    out << "->" << name;
 }
 
 void VariableDeclarationAST::analyse(SymbolTable &table) {
-    string initType;
+    TypeId initType;
     if (initializer) {
         initializer->analyse(table, initType);
     }
 
-    const string concreteTypeName = ensureTypeIsInstantiated(type.get(), table);
-    if (concreteTypeName == "error_type") {
+    const TypeId concreteType = ensureTypeIsInstantiated(type.get(), table);
+    if (concreteType == TypeTable::Error) {
         return;
     }
 
@@ -547,53 +651,58 @@ void VariableDeclarationAST::analyse(SymbolTable &table) {
         Logger::Error("Variable '" + name + "' already defined in this scope.");
         return;
     }
-    if (initializer && concreteTypeName != initType) {
-        Logger::Error("Type mismatch in variable declaration '" + name + "'. Expected '" + concreteTypeName + "' but got '" + initType + "'.");
+    if (initializer && concreteType != initType) {
+        Logger::Error("Type mismatch in variable declaration '" + name + "'. Expected '" + concreteType.name() + "' but got '" + initType.name() + "'.");
         return;
     }
 
-    table.addSymbol(name, {type->type, SymbolInfo::Variable});
+    table.addSymbol(name, {.type = TypeTable::Global().intern(type->type), .metaType = SymbolInfo::Variable, .declaration = this});
 }
 
-string VariableDeclarationAST::code() {
-    if (initializer)
-        return type->code() + ' ' + name + '=' + initializer->code();
-    return type->code() + ' ' + name;
+void VariableDeclarationAST::emit(CodeEmitter& out) {
+    type->emit(out);
+    out << ' ' << name;
+    if (initializer) {
+        out << '=';
+        initializer->emit(out);
+    }
 }
 
 void VariableAssignmentAST::analyse(SymbolTable &table) {
-    string targetType;
+    TypeId targetType;
     target->analyse(table, targetType);
-    const optional<SymbolInfo> lookup = table.lookupSymbol(targetType);
+    const optional<SymbolInfo> lookup = table.lookupSymbol(targetType.name());
     if (!lookup.has_value()) {
-        Logger::Error("Variable '"+targetType+"' does not exists.");
+        Logger::Error("Variable '"+targetType.name()+"' does not exists.");
     }
-    string assignment;
+    TypeId assignment;
     value->analyse(table, assignment);
     if (lookup.value().metaType != SymbolInfo::Variable || assignment != lookup.value().type) {
-        Logger::Error("Type mismatch in variable assignment '" + targetType + "'. Expected '" + lookup.value().type + "' but got '" + assignment + "'.");
+        Logger::Error("Type mismatch in variable assignment '" + targetType.name() + "'. Expected '" + lookup.value().type.name() + "' but got '" + assignment.name() + "'.");
     }
 }
 
-void VariableAssignmentAST::analyse(SymbolTable &table, string &a) {
-    string targetType;
+void VariableAssignmentAST::analyse(SymbolTable &table, TypeId &a) {
+    TypeId targetType;
     target->analyse(table, targetType);
 
-    if (targetType == "error_type") {
+    if (targetType == TypeTable::Error) {
         return; // Error already logged
     }
 
-    string valueType;
+    TypeId valueType;
     value->analyse(table, valueType);
 
     if (targetType != valueType) {
-        Logger::Error("Type mismatch in assignment. Cannot assign '" + valueType + "' to '" + targetType + "'.");
+        Logger::Error("Type mismatch in assignment. Cannot assign '" + valueType.name() + "' to '" + targetType.name() + "'.");
     }
 }
 
-string VariableAssignmentAST::code() {
+void VariableAssignmentAST::emit(CodeEmitter& out) {
     //if (accessor.empty()) {
-        return target->code() + " = " + value->code();
+        target->emit(out);
+        out << " = ";
+        value->emit(out);
     //}
 }
 
@@ -1,101 +1,173 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "ASTArena.h"
+#include "CodeEmitter.h"
 #include "Lexer.h"
+#include "SymbolInfo.h"
+#include "TypeTable.h"
 class SymbolTable;
 #include "SymbolTable.h"
 
 using namespace std;
 
+// Concrete type of a node, the passes switch on it instead of probing with dynamic_cast.
+// Expression kinds are kept contiguous, from FloatExpr to ExternExpr (see ExprAST::classof)
+enum class ASTKind : uint8_t {
+    Block,
+    ExternStatement,
+    Type,
+    FunctionParameter,
+    FunctionDefinition,
+    VariableDeclaration,
+    GenericParameter,
+    StructField,
+    StructDefinition,
+    ConstructorDefinition,
+    ExtendsStatement,
+    Return,
+    IfStatement,
+    FloatExpr,
+    IntExpr,
+    StringExpr,
+    VariableExpr,
+    FieldAccess,
+    OperationExpr,
+    FunctionCall,
+    MethodCall,
+    VariableAssignment,
+    ExternExpr,
+};
+
 class AST {
 public:
+    const ASTKind kind;
+    static bool classof(const ASTKind) { return true; }
+    explicit AST(const ASTKind kind) : kind(kind) {}
     virtual ~AST() = default;
+    // Nodes live in the current ASTArena of the thread, see ASTArena.h
+    static void* operator new(const size_t size) { return ASTArena::AllocateNode(size); }
+    static void operator delete(void* node) { ASTArena::FreeNode(node); }
     virtual void analyse(SymbolTable& table) {}
     virtual void prePass(SymbolTable& table) {}
-    virtual string code() {return "";}
+    // Appends the C code of the node to 'out'
+    virtual void emit(CodeEmitter& out) {}
+    // C code of the node alone, prefer emit() to generate a whole module
+    string code() {
+        CodeEmitter out;
+        emit(out);
+        return out.take();
+    }
     // Ajout de la méthode de clonage virtuelle pure
     [[nodiscard]] virtual unique_ptr<AST> clone() const = 0;
 };
 
 class BlockAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::Block; }
     std::vector<std::unique_ptr<AST>> statements;
-    explicit BlockAST(std::vector<std::unique_ptr<AST>> s) : statements(std::move(s)) {}
-    BlockAST() = default;
+    explicit BlockAST(std::vector<std::unique_ptr<AST>> s) : AST(ASTKind::Block), statements(std::move(s)) {}
+    BlockAST() : AST(ASTKind::Block) {}
     void prePass(SymbolTable& table) override;
     void analyse(SymbolTable& table) override;
-    string code() override;
+    // What analyse registers for the other modules (structures, templates, methods), without analysing the bodies
+    void declare(SymbolTable& table);
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class ExprAST : public AST {
 public:
+    static bool classof(const ASTKind k) { return k >= ASTKind::FloatExpr && k <= ASTKind::ExternExpr; }
+    explicit ExprAST(const ASTKind kind) : AST(kind) {}
     void prePass(SymbolTable& table) override;
-    virtual void analyse(SymbolTable& table, string& a) {}
-    string code() override { return ""; }
+    // 'a' receives the type of the expression
+    virtual void analyse(SymbolTable& table, TypeId& a) {}
 };
 
 class FloatExprAST final : public ExprAST {
+    friend class FlatAST;
     float val;
 public:
-    void analyse(SymbolTable& table, string& a) override;
-    explicit FloatExprAST(const float val) : val(val) {}
-    string code() override;
+    static bool classof(const ASTKind k) { return k == ASTKind::FloatExpr; }
+    void analyse(SymbolTable& table, TypeId& a) override;
+    explicit FloatExprAST(const float val) : ExprAST(ASTKind::FloatExpr), val(val) {}
+    [[nodiscard]] float value() const { return val; }
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class IntExprAST final : public ExprAST {
+    friend class FlatAST;
     int val;
 public:
-    void analyse(SymbolTable& table, string& a) override;
-    explicit IntExprAST(const int val) : val(val) {}
-    string code() override;
+    static bool classof(const ASTKind k) { return k == ASTKind::IntExpr; }
+    void analyse(SymbolTable& table, TypeId& a) override;
+    explicit IntExprAST(const int val) : ExprAST(ASTKind::IntExpr), val(val) {}
+    [[nodiscard]] int value() const { return val; }
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class StringExprAST final : public ExprAST {
+    friend class FlatAST;
     string val;
 public:
-    void analyse(SymbolTable& table, string& a) override;
-    explicit StringExprAST(string val) : val(std::move(val)) {}
-    string code() override;
+    static bool classof(const ASTKind k) { return k == ASTKind::StringExpr; }
+    void analyse(SymbolTable& table, TypeId& a) override;
+    explicit StringExprAST(string val) : ExprAST(ASTKind::StringExpr), val(std::move(val)) {}
+    [[nodiscard]] const string& value() const { return val; }
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class VariableExprAST : public ExprAST {
+protected:
+    VariableExprAST(const ASTKind kind, std::string name) : ExprAST(kind), isField(false), name(std::move(name)) {}
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::VariableExpr || k == ASTKind::FieldAccess; }
     bool isField;
     std::string name;
+    // Variable or field the name resolved to, set by the first successful analyse
+    optional<SymbolInfo> binding;
 
-    void analyse(SymbolTable& table, string& a) override;
-    explicit VariableExprAST(std::string name) : isField(false), name(std::move(name)) {}
-    string code() override;
+    void analyse(SymbolTable& table, TypeId& a) override;
+    explicit VariableExprAST(std::string name) : VariableExprAST(ASTKind::VariableExpr, std::move(name)) {}
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class OperationExprAST final : public ExprAST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::OperationExpr; }
     TokenType op;
     std::unique_ptr<ExprAST> LHS, RHS;
-    void analyse(SymbolTable& table, string& a) override;
+    void analyse(SymbolTable& table, TypeId& a) override;
     OperationExprAST(const TokenType op, std::unique_ptr<ExprAST> LHS, std::unique_ptr<ExprAST> RHS) :
-        op(op), LHS(std::move(LHS)), RHS(std::move(RHS)) {}
-    string code() override;
+        ExprAST(ASTKind::OperationExpr), op(op), LHS(std::move(LHS)), RHS(std::move(RHS)) {}
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class ExternStatementAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::ExternStatement; }
     std::string libraryName;
-    explicit ExternStatementAST(std::string libName) : libraryName(std::move(libName)) {}
+    explicit ExternStatementAST(std::string libName) : AST(ASTKind::ExternStatement), libraryName(std::move(libName)) {}
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class TypeAST final : public AST {
+    mutable std::atomic<TypeId> cachedId;
+    mutable std::atomic<bool> interned = false;
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::Type; }
     std::string type;
     std::vector<unique_ptr<TypeAST>> genericArgs;
     bool isArray = false;
@@ -103,36 +175,44 @@ public:
 
     void analyse(SymbolTable &table) override;
 
-    explicit TypeAST(string t) : type(std::move(t)) {}
-    TypeAST(string base, vector<unique_ptr<TypeAST>> args) : type(std::move(base)), genericArgs(std::move(args)) {}
-    explicit TypeAST(const unique_ptr<TypeAST> &type, std::unique_ptr<ExprAST> size) : type(type->type), arraySize(move(size)) {}
-
-    [[nodiscard]] string getMangledName() const {
-        string mangled = type;
-        if (!genericArgs.empty()) {
-            for (const auto& arg : genericArgs) {
-                mangled += '_' + arg->getMangledName();
-            }
-            //mangled.pop_back(); // Remove the last ,
+    explicit TypeAST(string t) : AST(ASTKind::Type), type(std::move(t)) {}
+    TypeAST(string base, vector<unique_ptr<TypeAST>> args) : AST(ASTKind::Type), type(std::move(base)), genericArgs(std::move(args)) {}
+    explicit TypeAST(const unique_ptr<TypeAST> &type, std::unique_ptr<ExprAST> size) : AST(ASTKind::Type), type(type->type), arraySize(move(size)) {}
+
+    // Interned type, computed on first use : the node must not change afterwards.
+    // The generation of a module reads its types while the modules importing it are analysed
+    [[nodiscard]] TypeId id() const {
+        if (!interned.load(std::memory_order_acquire)) {
+            cachedId.store(TypeTable::Global().intern(*this), std::memory_order_relaxed);
+            interned.store(true, std::memory_order_release);
         }
-        return mangled;
+        return cachedId.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] const string& getMangledName() const {
+        return id().name();
     }
 
-    string code() override;
+    // Type as written in the source, ex : "Box<int>"
+    [[nodiscard]] string source() const;
+
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class FunctionParameterAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::FunctionParameter; }
     std::unique_ptr<TypeAST> type;
     std::string name;
-    FunctionParameterAST(std::unique_ptr<TypeAST> t, std::string n) : type(std::move(t)), name(std::move(n)) {}
-    string code() override;
+    FunctionParameterAST(std::unique_ptr<TypeAST> t, std::string n) : AST(ASTKind::FunctionParameter), type(std::move(t)), name(std::move(n)) {}
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class FunctionDefinitionAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::FunctionDefinition; }
     std::unique_ptr<TypeAST> returnType;
     bool isStatic = false;
     std::string name;
@@ -143,152 +223,204 @@ public:
     void analyse(SymbolTable &table) override;
     void analyse(SymbolTable &table, const string& parentStruct);
     FunctionDefinitionAST(std::unique_ptr<TypeAST> retType, std::string n, std::vector<unique_ptr<FunctionParameterAST>> p, std::unique_ptr<AST> b, const bool isStatic = false)
-        : returnType(std::move(retType)), isStatic(isStatic), name(std::move(n)), params(std::move(p)), body(std::move(b)) {}
+        : AST(ASTKind::FunctionDefinition), returnType(std::move(retType)), isStatic(isStatic), name(std::move(n)), params(std::move(p)), body(std::move(b)) {}
+    using AST::code;
     string code(bool isMethod);
-    string code() override;
+    void emit(CodeEmitter& out, bool isMethod);
+    void emit(CodeEmitter& out) override;
     string getSignature();
+    // Entry of the function in its overload set, the caller qualifies the C name of methods
+    Overload overload();
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class FunctionCallAST : public ExprAST {
+protected:
+    FunctionCallAST(const ASTKind kind, string name, vector<unique_ptr<ExprAST>> params) :
+        ExprAST(kind), name(std::move(name)), params(move(params)) {}
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::FunctionCall || k == ASTKind::MethodCall; }
     std::string name;
     string signature;
     std::vector<unique_ptr<ExprAST>> params;
+    // Function, method or constructor the call resolved to, set by the first successful analyse
+    optional<SymbolInfo> binding;
 
-    void analyse(SymbolTable& table, string& a) override;
+    void analyse(SymbolTable& table, TypeId& a) override;
     FunctionCallAST(string name, vector<unique_ptr<ExprAST>> params) :
-        name(std::move(name)), params(move(params)) {}
-    string code() override;
+        FunctionCallAST(ASTKind::FunctionCall, std::move(name), move(params)) {}
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class MethodCallAST final : public FunctionCallAST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::MethodCall; }
     unique_ptr<ExprAST> ownerExpr;
-    void analyse(SymbolTable& table, string& a) override;
-    string code() override;
+    void analyse(SymbolTable& table, TypeId& a) override;
+    void emit(CodeEmitter& out) override;
     MethodCallAST(unique_ptr<ExprAST> owner, string name, vector<unique_ptr<ExprAST>> params) :
-        FunctionCallAST(move(name), move(params)), ownerExpr(move(owner)) {}
+        FunctionCallAST(ASTKind::MethodCall, move(name), move(params)), ownerExpr(move(owner)) {}
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class FieldAccessAST final : public VariableExprAST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::FieldAccess; }
     unique_ptr<ExprAST> ownerExpr;
-    void analyse(SymbolTable &table, string &a) override;
-    string code() override;
-    FieldAccessAST(unique_ptr<ExprAST> owner, string name) : VariableExprAST(move(name)), ownerExpr(move(owner)) {}
+    void analyse(SymbolTable &table, TypeId &a) override;
+    void emit(CodeEmitter& out) override;
+    FieldAccessAST(unique_ptr<ExprAST> owner, string name) : VariableExprAST(ASTKind::FieldAccess, move(name)), ownerExpr(move(owner)) {}
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class VariableDeclarationAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::VariableDeclaration; }
     std::unique_ptr<TypeAST> type;
     std::string name;
     std::unique_ptr<ExprAST> initializer;
 
     void analyse(SymbolTable& table) override;
     VariableDeclarationAST(std::unique_ptr<TypeAST> t, std::string n, std::unique_ptr<ExprAST> init)
-        : type(std::move(t)), name(std::move(n)), initializer(std::move(init)) {}
-    string code() override;
+        : AST(ASTKind::VariableDeclaration), type(std::move(t)), name(std::move(n)), initializer(std::move(init)) {}
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class VariableAssignmentAST final : public ExprAST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::VariableAssignment; }
     unique_ptr<ExprAST> target;
     unique_ptr<ExprAST> value;
     string accessor;
 
     void analyse(SymbolTable& table) override;
-    void analyse(SymbolTable& table, string& a) override;
-    string code() override;
+    void analyse(SymbolTable& table, TypeId& a) override;
+    void emit(CodeEmitter& out) override;
     VariableAssignmentAST(unique_ptr<ExprAST> target, unique_ptr<ExprAST> val)
-        : target(std::move(target)), value(std::move(val)) {}
+        : ExprAST(ASTKind::VariableAssignment), target(std::move(target)), value(std::move(val)) {}
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class GenericParameterAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::GenericParameter; }
     std::string name;
-    explicit GenericParameterAST(std::string n) : name(std::move(n)) {}
+    explicit GenericParameterAST(std::string n) : AST(ASTKind::GenericParameter), name(std::move(n)) {}
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class StructFieldAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::StructField; }
     std::unique_ptr<TypeAST> type;
     std::string name;
-    StructFieldAST(unique_ptr<TypeAST> t, string n) : type(move(t)), name(move(n)) {}
-    string code() override;
+    StructFieldAST(unique_ptr<TypeAST> t, string n) : AST(ASTKind::StructField), type(move(t)), name(move(n)) {}
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class StructDefinitionAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::StructDefinition; }
     std::string name;
     std::vector<std::unique_ptr<GenericParameterAST>> genericParams;
     std::vector<std::unique_ptr<StructFieldAST>> fields;
+    TypeId instanceOf = TypeTable::None; // Generic type an instantiation was made for (see ensureTypeIsInstantiated)
+
+    // Type of the structure : an instantiation is its generic type, not the plain type spelled like its name
+    [[nodiscard]] TypeId structType() const {
+        return instanceOf != TypeTable::None ? instanceOf : TypeTable::Global().intern(name);
+    }
 
     void prePass(SymbolTable& table) override;
     void analyse(SymbolTable& table) override;
     StructDefinitionAST(std::string n, std::vector<unique_ptr<GenericParameterAST>> g, std::vector<unique_ptr<StructFieldAST>> f)
-        : name(std::move(n)), genericParams(std::move(g)), fields(std::move(f)) {}
+        : AST(ASTKind::StructDefinition), name(std::move(n)), genericParams(std::move(g)), fields(std::move(f)) {}
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class ConstructorDefinitionAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::ConstructorDefinition; }
     string structName;
     std::vector<std::unique_ptr<FunctionParameterAST>> params;
     std::unique_ptr<AST> body;
 
     void prePass(SymbolTable& table) override;
     void analyse(SymbolTable& table) override;
-    string code() override;
+    void emit(CodeEmitter& out) override;
     string getSignature();
     ConstructorDefinitionAST(string structName, std::vector<unique_ptr<FunctionParameterAST>> p, unique_ptr<AST> b)
-        : structName(std::move(structName)), params(std::move(p)), body(std::move(b)) {}
+        : AST(ASTKind::ConstructorDefinition), structName(std::move(structName)), params(std::move(p)), body(std::move(b)) {}
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class ExtendsStatementAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::ExtendsStatement; }
     std::string structName;
     std::string parentStructName;
     std::vector<std::unique_ptr<AST>> members;
 
     void analyse(SymbolTable& table) override;
-    ExtendsStatementAST(std::string name, std::vector<unique_ptr<AST>> m) : structName(std::move(name)), members(std::move(m)) {}
+    // Registers the methods without analysing their bodies
+    void declare(SymbolTable& table);
+    ExtendsStatementAST(std::string name, std::vector<unique_ptr<AST>> m) : AST(ASTKind::ExtendsStatement), structName(std::move(name)), members(std::move(m)) {}
     ExtendsStatementAST(std::string childName, std::string parentName, vector<unique_ptr<AST>> members = {}) :
-        structName(std::move(childName)), parentStructName(std::move(parentName)), members(move(members)) {}
+        AST(ASTKind::ExtendsStatement), structName(std::move(childName)), parentStructName(std::move(parentName)), members(move(members)) {}
     bool isFieldOnly();
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class ReturnAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::Return; }
     unique_ptr<ExprAST> value;
-    explicit ReturnAST(unique_ptr<ExprAST> value) : value(move(value)) {}
-    string code() override;
+    explicit ReturnAST(unique_ptr<ExprAST> value) : AST(ASTKind::Return), value(move(value)) {}
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class IfStatementAST final : public AST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::IfStatement; }
     unique_ptr<ExprAST> condition;
     unique_ptr<AST> thenBody;
     unique_ptr<AST> elseBody;
     IfStatementAST(unique_ptr<ExprAST> condition, unique_ptr<AST> a, unique_ptr<AST> b = nullptr) :
-        condition(move(condition)), thenBody(move(a)), elseBody(move(b)) {}
+        AST(ASTKind::IfStatement), condition(move(condition)), thenBody(move(a)), elseBody(move(b)) {}
     [[nodiscard]] unique_ptr<AST> clone() const override;
 };
 
 class ExternExprAST final : public ExprAST {
 public:
+    static bool classof(const ASTKind k) { return k == ASTKind::ExternExpr; }
     string body;
-    explicit ExternExprAST(string body) : body(std::move(body)) {}
-    string code() override;
+    explicit ExternExprAST(string body) : ExprAST(ASTKind::ExternExpr), body(std::move(body)) {}
+    void emit(CodeEmitter& out) override;
     [[nodiscard]] unique_ptr<AST> clone() const override;
-};
\ No newline at end of file
+};
+
+// Checked casts on the kind tag : 'T::classof' tells which kinds are a T
+template <typename T>
+bool isa(const AST* node) {
+    return node != nullptr && T::classof(node->kind);
+}
+
+template <typename T>
+T* ast_cast(AST* node) {
+    return isa<T>(node) ? static_cast<T*>(node) : nullptr;
+}
+
+template <typename T>
+const T* ast_cast(const AST* node) {
+    return isa<T>(node) ? static_cast<const T*>(node) : nullptr;
+}
+
+// Deep copy keeping the static type, clone() always returns a node of the same kind
+template <typename T>
+unique_ptr<T> cloneAs(const T& node) {
+    return unique_ptr<T>(static_cast<T*>(node.clone().release()));
+}
@@ -0,0 +1,88 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ASTArena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    thread_local ASTArena* currentArena = nullptr;
+
+    std::atomic<size_t> heapNodes {0};
+    std::atomic<size_t> arenaNodes {0};
+    std::atomic<size_t> arenaChunks {0};
+
+    // Placed before every node, tells FreeNode where the node comes from
+    struct alignas(std::max_align_t) NodeHeader {
+        bool inArena;
+    };
+
+    constexpr size_t align(const size_t size) {
+        return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    }
+}
+
+ASTArena::Scope::Scope(ASTArena& arena) : previous(currentArena) {
+    currentArena = &arena;
+}
+
+ASTArena::Scope::~Scope() {
+    currentArena = previous;
+}
+
+ASTArena::ASTArena(const size_t chunkSize) : chunkSize(chunkSize) {}
+
+void ASTArena::grow(const size_t minimum) {
+    const size_t size = std::max(chunkSize, minimum);
+    chunks.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+    cursor = chunks.back().get();
+    limit = cursor + size;
+    ++arenaChunks;
+}
+
+void* ASTArena::allocate(size_t size) {
+    size = align(size);
+    if (static_cast<size_t>(limit - cursor) < size) {
+        grow(size);
+    }
+    void* result = cursor;
+    cursor += size;
+    used += size;
+    return result;
+}
+
+void* ASTArena::AllocateNode(const size_t size) {
+    void* memory;
+    if (currentArena) {
+        memory = currentArena->allocate(sizeof(NodeHeader) + size);
+        ++arenaNodes;
+    } else {
+        memory = std::malloc(sizeof(NodeHeader) + size);
+        if (!memory) throw std::bad_alloc();
+        ++heapNodes;
+    }
+    const auto header = new (memory) NodeHeader{currentArena != nullptr};
+    return header + 1;
+}
+
+void ASTArena::FreeNode(void* node) {
+    if (!node) return;
+    const auto header = static_cast<NodeHeader*>(node) - 1;
+    if (!header->inArena) {
+        std::free(header);
+    }
+    // Arena nodes are released with their arena
+}
+
+ASTArena::Counters ASTArena::Count() {
+    return {heapNodes.load(), arenaNodes.load(), arenaChunks.load()};
+}
+
+void ASTArena::ResetCount() {
+    heapNodes = 0;
+    arenaNodes = 0;
+    arenaChunks = 0;
+}
@@ -0,0 +1,64 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef ASTARENA_H
+#define ASTARENA_H
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Bump allocator owning the AST nodes of a module
+ *
+ * Every AST node is allocated through AST::operator new, which takes memory from the arena
+ * made current on the calling thread by an ASTArena::Scope (or from the heap when there is none).
+ * Allocating a node is a pointer bump, deleting an arena node only runs its destructor :
+ * the memory is given back all at once, when the arena is destroyed.
+ * An arena must therefore outlive every node allocated in it.
+ */
+class ASTArena {
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+    std::byte* cursor = nullptr;
+    std::byte* limit = nullptr;
+    size_t chunkSize;
+    size_t used = 0;
+
+    void grow(size_t minimum);
+
+public:
+    // Allocation counters of AST nodes, over the whole process
+    struct Counters {
+        size_t heapNodes;  // Nodes allocated with malloc (no current arena)
+        size_t arenaNodes; // Nodes bumped in an arena
+        size_t chunks;     // Arena chunks allocated with malloc
+    };
+
+    // Makes an arena current on this thread for its lifetime
+    class Scope {
+        ASTArena* previous;
+    public:
+        explicit Scope(ASTArena& arena);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    explicit ASTArena(size_t chunkSize = 64 * 1024);
+    ASTArena(const ASTArena&) = delete;
+    ASTArena& operator=(const ASTArena&) = delete;
+
+    void* allocate(size_t size);
+    [[nodiscard]] size_t bytesUsed() const { return used; }
+    [[nodiscard]] size_t chunkCount() const { return chunks.size(); }
+
+    // Used by AST::operator new / delete
+    static void* AllocateNode(size_t size);
+    static void FreeNode(void* node);
+
+    static Counters Count();
+    static void ResetCount();
+};
+
+#endif //ASTARENA_H
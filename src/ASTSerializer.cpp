@@ -0,0 +1,379 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ASTSerializer.h"
+
+#include <bit>
+#include <cstdint>
+
+// Start of every serialized module, the version changes along with the format
+static constexpr std::string_view Magic = "OXAST";
+static constexpr uint64_t Version = 1;
+static constexpr uint8_t NullNode = 0xFF;
+
+class ASTWriter {
+    string& out;
+public:
+    explicit ASTWriter(string& out) : out(out) {}
+
+    void byte(const uint8_t value) { out.push_back(static_cast<char>(value)); }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            byte(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        byte(static_cast<uint8_t>(value));
+    }
+
+    // Zigzag encoded : small negative numbers stay short
+    void integer(const int64_t value) {
+        varint(static_cast<uint64_t>(value) << 1 ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void real(const float value) {
+        const auto bits = std::bit_cast<uint32_t>(value);
+        for (int shift = 0; shift < 32; shift += 8) {
+            byte(static_cast<uint8_t>(bits >> shift));
+        }
+    }
+
+    void str(const string_view value) {
+        varint(value.size());
+        out.append(value);
+    }
+
+    template <typename Node>
+    void nodes(const vector<unique_ptr<Node>>& list) {
+        varint(list.size());
+        for (const auto& node : list) {
+            this->node(node.get());
+        }
+    }
+
+    void node(const AST* node);
+};
+
+void ASTWriter::node(const AST* node) {
+    if (!node) {
+        byte(NullNode);
+        return;
+    }
+    byte(static_cast<uint8_t>(node->kind));
+    switch (node->kind) {
+        case ASTKind::Block:
+            nodes(static_cast<const BlockAST*>(node)->statements);
+            break;
+        case ASTKind::ExternStatement:
+            str(static_cast<const ExternStatementAST*>(node)->libraryName);
+            break;
+        case ASTKind::Type: {
+            const auto* type = static_cast<const TypeAST*>(node);
+            str(type->type);
+            nodes(type->genericArgs);
+            byte(type->isArray);
+            this->node(type->arraySize.get());
+            break;
+        }
+        case ASTKind::FunctionParameter: {
+            const auto* param = static_cast<const FunctionParameterAST*>(node);
+            this->node(param->type.get());
+            str(param->name);
+            break;
+        }
+        case ASTKind::FunctionDefinition: {
+            const auto* function = static_cast<const FunctionDefinitionAST*>(node);
+            this->node(function->returnType.get());
+            byte(function->isStatic);
+            str(function->name);
+            nodes(function->params);
+            this->node(function->body.get());
+            break;
+        }
+        case ASTKind::VariableDeclaration: {
+            const auto* declaration = static_cast<const VariableDeclarationAST*>(node);
+            this->node(declaration->type.get());
+            str(declaration->name);
+            this->node(declaration->initializer.get());
+            break;
+        }
+        case ASTKind::GenericParameter:
+            str(static_cast<const GenericParameterAST*>(node)->name);
+            break;
+        case ASTKind::StructField: {
+            const auto* field = static_cast<const StructFieldAST*>(node);
+            this->node(field->type.get());
+            str(field->name);
+            break;
+        }
+        case ASTKind::StructDefinition: {
+            const auto* structure = static_cast<const StructDefinitionAST*>(node);
+            str(structure->name);
+            nodes(structure->genericParams);
+            nodes(structure->fields);
+            break;
+        }
+        case ASTKind::ConstructorDefinition: {
+            const auto* constructor = static_cast<const ConstructorDefinitionAST*>(node);
+            str(constructor->structName);
+            nodes(constructor->params);
+            this->node(constructor->body.get());
+            break;
+        }
+        case ASTKind::ExtendsStatement: {
+            const auto* extends = static_cast<const ExtendsStatementAST*>(node);
+            str(extends->structName);
+            str(extends->parentStructName);
+            nodes(extends->members);
+            break;
+        }
+        case ASTKind::Return:
+            this->node(static_cast<const ReturnAST*>(node)->value.get());
+            break;
+        case ASTKind::IfStatement: {
+            const auto* ifStatement = static_cast<const IfStatementAST*>(node);
+            this->node(ifStatement->condition.get());
+            this->node(ifStatement->thenBody.get());
+            this->node(ifStatement->elseBody.get());
+            break;
+        }
+        case ASTKind::FloatExpr:
+            real(static_cast<const FloatExprAST*>(node)->value());
+            break;
+        case ASTKind::IntExpr:
+            integer(static_cast<const IntExprAST*>(node)->value());
+            break;
+        case ASTKind::StringExpr:
+            str(static_cast<const StringExprAST*>(node)->value());
+            break;
+        case ASTKind::VariableExpr:
+            str(static_cast<const VariableExprAST*>(node)->name);
+            break;
+        case ASTKind::FieldAccess: {
+            const auto* access = static_cast<const FieldAccessAST*>(node);
+            this->node(access->ownerExpr.get());
+            str(access->name);
+            break;
+        }
+        case ASTKind::OperationExpr: {
+            const auto* operation = static_cast<const OperationExprAST*>(node);
+            varint(static_cast<uint64_t>(operation->op));
+            this->node(operation->LHS.get());
+            this->node(operation->RHS.get());
+            break;
+        }
+        case ASTKind::FunctionCall: {
+            const auto* call = static_cast<const FunctionCallAST*>(node);
+            str(call->name);
+            nodes(call->params);
+            break;
+        }
+        case ASTKind::MethodCall: {
+            const auto* call = static_cast<const MethodCallAST*>(node);
+            this->node(call->ownerExpr.get());
+            str(call->name);
+            nodes(call->params);
+            break;
+        }
+        case ASTKind::VariableAssignment: {
+            const auto* assignment = static_cast<const VariableAssignmentAST*>(node);
+            this->node(assignment->target.get());
+            this->node(assignment->value.get());
+            break;
+        }
+        case ASTKind::ExternExpr:
+            str(static_cast<const ExternExprAST*>(node)->body);
+            break;
+    }
+}
+
+string serializeAST(const BlockAST& module) {
+    string bytes;
+    ASTWriter writer(bytes);
+    bytes.append(Magic);
+    writer.varint(Version);
+    writer.node(&module);
+    return bytes;
+}
+
+// Thrown on truncated or inconsistent input, caught by deserializeAST
+struct MalformedAST {};
+
+class ASTReader {
+    string_view bytes;
+    size_t position = 0;
+public:
+    explicit ASTReader(const string_view bytes) : bytes(bytes) {}
+
+    [[nodiscard]] bool atEnd() const { return position == bytes.size(); }
+
+    uint8_t byte() {
+        if (position >= bytes.size()) throw MalformedAST();
+        return static_cast<uint8_t>(bytes[position++]);
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint8_t next = byte();
+            value |= static_cast<uint64_t>(next & 0x7F) << shift;
+            if (!(next & 0x80)) return value;
+        }
+        throw MalformedAST();
+    }
+
+    int64_t integer() {
+        const uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1 ^ -(value & 1));
+    }
+
+    float real() {
+        uint32_t bits = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            bits |= static_cast<uint32_t>(byte()) << shift;
+        }
+        return std::bit_cast<float>(bits);
+    }
+
+    string_view view(const size_t size) {
+        if (size > bytes.size() - position) throw MalformedAST();
+        const string_view value = bytes.substr(position, size);
+        position += size;
+        return value;
+    }
+
+    string str() { return string(view(varint())); }
+
+    unique_ptr<AST> node();
+
+    // Node of kind 'Node' or null, anything else is malformed
+    template <typename Node>
+    unique_ptr<Node> child() {
+        unique_ptr<AST> read = node();
+        if (read && !isa<Node>(read.get())) throw MalformedAST();
+        return unique_ptr<Node>(static_cast<Node*>(read.release()));
+    }
+
+    template <typename Node>
+    vector<unique_ptr<Node>> children() {
+        const uint64_t count = varint();
+        // Every node takes at least one byte : a larger count can not be valid
+        if (count > bytes.size() - position) throw MalformedAST();
+        vector<unique_ptr<Node>> list;
+        list.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            list.push_back(child<Node>());
+        }
+        return list;
+    }
+};
+
+unique_ptr<AST> ASTReader::node() {
+    const uint8_t kind = byte();
+    if (kind == NullNode) return nullptr;
+    if (kind > static_cast<uint8_t>(ASTKind::ExternExpr)) throw MalformedAST();
+    // Fields are read in separate statements : the evaluation order of constructor arguments is unspecified
+    switch (static_cast<ASTKind>(kind)) {
+        case ASTKind::Block:
+            return make_unique<BlockAST>(children<AST>());
+        case ASTKind::ExternStatement:
+            return make_unique<ExternStatementAST>(str());
+        case ASTKind::Type: {
+            string name = str();
+            auto type = make_unique<TypeAST>(move(name), children<TypeAST>());
+            type->isArray = byte() != 0;
+            type->arraySize = child<ExprAST>();
+            return type;
+        }
+        case ASTKind::FunctionParameter: {
+            auto type = child<TypeAST>();
+            return make_unique<FunctionParameterAST>(move(type), str());
+        }
+        case ASTKind::FunctionDefinition: {
+            auto returnType = child<TypeAST>();
+            const bool isStatic = byte() != 0;
+            string name = str();
+            auto params = children<FunctionParameterAST>();
+            return make_unique<FunctionDefinitionAST>(move(returnType), move(name), move(params), node(), isStatic);
+        }
+        case ASTKind::VariableDeclaration: {
+            auto type = child<TypeAST>();
+            string name = str();
+            return make_unique<VariableDeclarationAST>(move(type), move(name), child<ExprAST>());
+        }
+        case ASTKind::GenericParameter:
+            return make_unique<GenericParameterAST>(str());
+        case ASTKind::StructField: {
+            auto type = child<TypeAST>();
+            return make_unique<StructFieldAST>(move(type), str());
+        }
+        case ASTKind::StructDefinition: {
+            string name = str();
+            auto genericParams = children<GenericParameterAST>();
+            return make_unique<StructDefinitionAST>(move(name), move(genericParams), children<StructFieldAST>());
+        }
+        case ASTKind::ConstructorDefinition: {
+            string structName = str();
+            auto params = children<FunctionParameterAST>();
+            return make_unique<ConstructorDefinitionAST>(move(structName), move(params), node());
+        }
+        case ASTKind::ExtendsStatement: {
+            string structName = str();
+            string parentName = str();
+            return make_unique<ExtendsStatementAST>(move(structName), move(parentName), children<AST>());
+        }
+        case ASTKind::Return:
+            return make_unique<ReturnAST>(child<ExprAST>());
+        case ASTKind::IfStatement: {
+            auto condition = child<ExprAST>();
+            auto thenBody = node();
+            return make_unique<IfStatementAST>(move(condition), move(thenBody), node());
+        }
+        case ASTKind::FloatExpr:
+            return make_unique<FloatExprAST>(real());
+        case ASTKind::IntExpr:
+            return make_unique<IntExprAST>(static_cast<int>(integer()));
+        case ASTKind::StringExpr:
+            return make_unique<StringExprAST>(str());
+        case ASTKind::VariableExpr:
+            return make_unique<VariableExprAST>(str());
+        case ASTKind::FieldAccess: {
+            auto owner = child<ExprAST>();
+            return make_unique<FieldAccessAST>(move(owner), str());
+        }
+        case ASTKind::OperationExpr: {
+            const auto op = static_cast<TokenType>(varint());
+            auto lhs = child<ExprAST>();
+            return make_unique<OperationExprAST>(op, move(lhs), child<ExprAST>());
+        }
+        case ASTKind::FunctionCall: {
+            string name = str();
+            return make_unique<FunctionCallAST>(move(name), children<ExprAST>());
+        }
+        case ASTKind::MethodCall: {
+            auto owner = child<ExprAST>();
+            string name = str();
+            return make_unique<MethodCallAST>(move(owner), move(name), children<ExprAST>());
+        }
+        case ASTKind::VariableAssignment: {
+            auto target = child<ExprAST>();
+            return make_unique<VariableAssignmentAST>(move(target), child<ExprAST>());
+        }
+        case ASTKind::ExternExpr:
+            return make_unique<ExternExprAST>(str());
+    }
+    throw MalformedAST();
+}
+
+unique_ptr<BlockAST> deserializeAST(const string_view bytes) {
+    if (!bytes.starts_with(Magic)) return nullptr;
+    ASTReader reader(bytes.substr(Magic.size()));
+    try {
+        if (reader.varint() != Version) return nullptr;
+        auto module = reader.child<BlockAST>();
+        return reader.atEnd() ? move(module) : nullptr;
+    } catch (const MalformedAST&) {
+        return nullptr;
+    }
+}
@@ -0,0 +1,26 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef ASTSERIALIZER_H
+#define ASTSERIALIZER_H
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "AST.h"
+
+/**
+ * @brief Compact binary form of a parsed module, to load it again without lexing and parsing
+ *
+ * The nodes are written in pre-order : the kind on one byte, then the fields of the node and its
+ * children. Counts, lengths and integers are variable-length, strings are stored inline.
+ * Only what the parser sets is kept (what clone() copies) : the analysis results are not.
+ * The format starts with a magic number and a version, anything else is rejected by deserializeAST.
+ */
+std::string serializeAST(const BlockAST& module);
+
+// Tree of 'bytes' allocated in the current ASTArena, null if they are not a valid serialized module
+std::unique_ptr<BlockAST> deserializeAST(std::string_view bytes);
+
+#endif //ASTSERIALIZER_H
@@ -0,0 +1,133 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "BuildState.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "ContentHash.h"
+
+// First line of the state file, to be changed along with its format
+static constexpr string_view StateHeader = "onyx-build-state 1";
+
+// State file : the header, the main module, then one line per module and per generic instantiation,
+// each made of a tag and its fields, the free text last
+bool BuildState::load(const filesystem::path& file) {
+    ifstream stream(file);
+    string line;
+    if (!getline(stream, line) || line != StateHeader) {
+        return false;
+    }
+    while (getline(stream, line)) {
+        istringstream fields(line);
+        string tag, name;
+        fields >> tag >> name;
+        if (tag == "main") {
+            mainModule = name;
+        } else if (tag == "module") {
+            Module& module = modules[name];
+            fields >> module.sourceHash >> module.interfaceHash >> module.hadErrors;
+        } else if (tag == "instantiation") {
+            string type;
+            getline(fields >> ws, type);
+            modules[name].instantiations.push_back(type);
+        } else {
+            return false;
+        }
+        if (fields.fail()) return false;
+    }
+    return true;
+}
+
+void BuildState::save(const filesystem::path& file) const {
+    error_code error;
+    filesystem::create_directories(file.parent_path(), error);
+    const filesystem::path temporary = file.string() + ".tmp";
+    {
+        ofstream stream(temporary);
+        if (!stream.is_open()) return;
+        stream << StateHeader << '\n';
+        stream << "main " << mainModule << '\n';
+        for (const auto& [name, module] : modules) {
+            stream << "module " << name << ' ' << module.sourceHash << ' ' << module.interfaceHash << ' ' << module.hadErrors << '\n';
+            for (const auto& type : module.instantiations) {
+                stream << "instantiation " << name << ' ' << type << '\n';
+            }
+        }
+    }
+    filesystem::rename(temporary, file, error);
+}
+
+string BuildState::sourceHash(const filesystem::path& source) {
+    ifstream stream(source, ios::binary);
+    ostringstream content;
+    content << stream.rdbuf();
+    ContentHash hash;
+    hash.add(content.str());
+    return hash.str();
+}
+
+static void addParameters(ContentHash& hash, const vector<unique_ptr<FunctionParameterAST>>& params) {
+    for (const auto& param : params) {
+        hash.add(param->type->source());
+    }
+}
+
+// Function signature : what a call from another module is resolved and emitted against
+static void addFunction(ContentHash& hash, const FunctionDefinitionAST& function) {
+    hash.add(function.isStatic ? "static function" : "function");
+    hash.add(function.returnType->source());
+    hash.add(function.name);
+    addParameters(hash, function.params);
+}
+
+static void addMember(ContentHash& hash, const AST& member) {
+    if (const auto function = ast_cast<FunctionDefinitionAST>(&member)) {
+        addFunction(hash, *function);
+    } else if (const auto constructor = ast_cast<ConstructorDefinitionAST>(&member)) {
+        hash.add("constructor");
+        hash.add(constructor->structName);
+        addParameters(hash, constructor->params);
+    } else if (const auto field = ast_cast<StructFieldAST>(&member)) {
+        hash.add("field");
+        hash.add(field->type->source());
+        hash.add(field->name);
+    }
+}
+
+string BuildState::interfaceHash(const BlockAST& module) {
+    ContentHash hash;
+    for (const auto& statement : module.statements) {
+        const AST* node = statement.get();
+        if (const auto structure = ast_cast<StructDefinitionAST>(node)) {
+            // Generic structures are instantiated by the importing modules : the fields are part of the interface
+            hash.add("struct");
+            hash.add(structure->name);
+            for (const auto& param : structure->genericParams) {
+                hash.add(param->name);
+            }
+            for (const auto& field : structure->fields) {
+                addMember(hash, *field);
+            }
+        } else if (const auto extends = ast_cast<ExtendsStatementAST>(node)) {
+            hash.add("extends");
+            hash.add(extends->structName);
+            hash.add(extends->parentStructName);
+            for (const auto& member : extends->members) {
+                addMember(hash, *member);
+            }
+        } else if (const auto declaration = ast_cast<VariableDeclarationAST>(node)) {
+            hash.add("variable");
+            hash.add(declaration->type->source());
+            hash.add(declaration->name);
+        } else if (const auto externBlock = ast_cast<ExternExprAST>(node)) {
+            hash.add("extern");
+            hash.add(externBlock->body);
+        } else {
+            addMember(hash, *node);
+        }
+    }
+    return hash.str();
+}
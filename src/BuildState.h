@@ -0,0 +1,45 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef BUILDSTATE_H
+#define BUILDSTATE_H
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "AST.h"
+
+using namespace std;
+
+/**
+ * @brief What the previous compile knew about each module, to only redo the modules that changed
+ *
+ * A module is recorded with the hash of its source and the hash of its interface : what the
+ * modules importing it can see (structures, function signatures, extern blocks), not the bodies.
+ * A module can skip its analysis and code generation when its source and the interfaces of its
+ * imports have the same hashes as in the previous compile. The generic instantiations its
+ * analysis used are recorded too, to be instantiated again without it.
+ */
+class BuildState {
+public:
+    struct Module {
+        string sourceHash;
+        string interfaceHash;
+        bool hadErrors = false;         // Always redone, to report the errors again
+        vector<string> instantiations;  // Generic types used by its analysis, as written in the source
+    };
+
+    string mainModule;
+    map<string, Module> modules;
+
+    // False if there is no valid state in 'file'
+    bool load(const filesystem::path& file);
+    void save(const filesystem::path& file) const;
+
+    static string sourceHash(const filesystem::path& source);
+    static string interfaceHash(const BlockAST& module);
+};
+
+#endif //BUILDSTATE_H
@@ -29,8 +29,8 @@ unique_ptr<AST> VariableExprAST::clone() const {
 }
 
 unique_ptr<AST> OperationExprAST::clone() const {
-    auto clonedLHS = unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(LHS->clone().release()));
-    auto clonedRHS = unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(RHS->clone().release()));
+    auto clonedLHS = cloneAs(*LHS);
+    auto clonedRHS = cloneAs(*RHS);
     return make_unique<OperationExprAST>(op, move(clonedLHS), move(clonedRHS));
 }
 
@@ -41,9 +41,9 @@ unique_ptr<AST> ExternStatementAST::clone() const {
 unique_ptr<AST> TypeAST::clone() const {
     auto clonedArgs = vector<unique_ptr<TypeAST>>();
     for (const auto& arg : genericArgs) {
-        clonedArgs.push_back(unique_ptr<TypeAST>(dynamic_cast<TypeAST*>(arg->clone().release())));
+        clonedArgs.push_back(cloneAs(*arg));
     }
-    auto clonedSize = arraySize ? unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(arraySize->clone().release())) : nullptr;
+    auto clonedSize = arraySize ? cloneAs(*arraySize) : nullptr;
     auto clonedType = make_unique<TypeAST>(type, move(clonedArgs));
     clonedType->isArray = isArray;
     clonedType->arraySize = move(clonedSize);
@@ -51,15 +51,15 @@ unique_ptr<AST> TypeAST::clone() const {
 }
 
 unique_ptr<AST> FunctionParameterAST::clone() const {
-    auto clonedType = unique_ptr<TypeAST>(dynamic_cast<TypeAST*>(type->clone().release()));
+    auto clonedType = cloneAs(*type);
     return make_unique<FunctionParameterAST>(move(clonedType), name);
 }
 
 unique_ptr<AST> FunctionDefinitionAST::clone() const {
-    auto clonedReturnType = unique_ptr<TypeAST>(dynamic_cast<TypeAST*>(returnType->clone().release()));
+    auto clonedReturnType = cloneAs(*returnType);
     auto clonedParams = vector<unique_ptr<FunctionParameterAST>>();
     for (const auto& p : params) {
-        clonedParams.push_back(unique_ptr<FunctionParameterAST>(dynamic_cast<FunctionParameterAST*>(p->clone().release())));
+        clonedParams.push_back(cloneAs(*p));
     }
     auto clonedBody = body->clone();
     return make_unique<FunctionDefinitionAST>(move(clonedReturnType), name, move(clonedParams), move(clonedBody), isStatic);
@@ -68,34 +68,34 @@ unique_ptr<AST> FunctionDefinitionAST::clone() const {
 unique_ptr<AST> FunctionCallAST::clone() const {
     auto clonedParams = vector<unique_ptr<ExprAST>>();
     for (const auto& p : params) {
-        clonedParams.push_back(unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(p->clone().release())));
+        clonedParams.push_back(cloneAs(*p));
     }
     return make_unique<FunctionCallAST>(name, move(clonedParams));
 }
 
 unique_ptr<AST> MethodCallAST::clone() const {
-    auto clonedOwner = unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(ownerExpr->clone().release()));
+    auto clonedOwner = cloneAs(*ownerExpr);
     auto clonedParams = vector<unique_ptr<ExprAST>>();
     for (const auto& p : params) {
-        clonedParams.push_back(unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(p->clone().release())));
+        clonedParams.push_back(cloneAs(*p));
     }
     return make_unique<MethodCallAST>(move(clonedOwner), name, move(clonedParams));
 }
 
 unique_ptr<AST> FieldAccessAST::clone() const {
-    auto clonedOwner = unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(ownerExpr->clone().release()));
+    auto clonedOwner = cloneAs(*ownerExpr);
     return make_unique<FieldAccessAST>(move(clonedOwner), name);
 }
 
 unique_ptr<AST> VariableDeclarationAST::clone() const {
-    auto clonedType = unique_ptr<TypeAST>(dynamic_cast<TypeAST*>(type->clone().release()));
-    auto clonedInitializer = initializer ? unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(initializer->clone().release())) : nullptr;
+    auto clonedType = cloneAs(*type);
+    auto clonedInitializer = initializer ? cloneAs(*initializer) : nullptr;
     return make_unique<VariableDeclarationAST>(move(clonedType), name, move(clonedInitializer));
 }
 
 unique_ptr<AST> VariableAssignmentAST::clone() const {
-    auto clonedTarget = unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(target->clone().release()));
-    auto clonedValue = unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(value->clone().release()));
+    auto clonedTarget = cloneAs(*target);
+    auto clonedValue = cloneAs(*value);
     return make_unique<VariableAssignmentAST>(move(clonedTarget), move(clonedValue));
 }
 
@@ -104,18 +104,18 @@ unique_ptr<AST> GenericParameterAST::clone() const {
 }
 
 unique_ptr<AST> StructFieldAST::clone() const {
-    auto clonedType = unique_ptr<TypeAST>(dynamic_cast<TypeAST*>(type->clone().release()));
+    auto clonedType = cloneAs(*type);
     return make_unique<StructFieldAST>(move(clonedType), name);
 }
 
 unique_ptr<AST> StructDefinitionAST::clone() const {
     auto clonedGenericParams = vector<unique_ptr<GenericParameterAST>>();
     for (const auto& p : genericParams) {
-        clonedGenericParams.push_back(unique_ptr<GenericParameterAST>(dynamic_cast<GenericParameterAST*>(p->clone().release())));
+        clonedGenericParams.push_back(cloneAs(*p));
     }
     auto clonedFields = vector<unique_ptr<StructFieldAST>>();
     for (const auto& f : fields) {
-        clonedFields.push_back(unique_ptr<StructFieldAST>(dynamic_cast<StructFieldAST*>(f->clone().release())));
+        clonedFields.push_back(cloneAs(*f));
     }
     return make_unique<StructDefinitionAST>(name, move(clonedGenericParams), move(clonedFields));
 }
@@ -123,7 +123,7 @@ unique_ptr<AST> StructDefinitionAST::clone() const {
 unique_ptr<AST> ConstructorDefinitionAST::clone() const {
     auto clonedParams = vector<unique_ptr<FunctionParameterAST>>();
     for (const auto& p : params) {
-        clonedParams.push_back(unique_ptr<FunctionParameterAST>(dynamic_cast<FunctionParameterAST*>(p->clone().release())));
+        clonedParams.push_back(cloneAs(*p));
     }
     auto clonedBody = body->clone();
     return make_unique<ConstructorDefinitionAST>(structName, move(clonedParams), move(clonedBody));
@@ -138,12 +138,12 @@ unique_ptr<AST> ExtendsStatementAST::clone() const {
 }
 
 unique_ptr<AST> ReturnAST::clone() const {
-    auto clonedValue = unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(value->clone().release()));
+    auto clonedValue = cloneAs(*value);
     return make_unique<ReturnAST>(move(clonedValue));
 }
 
 unique_ptr<AST> IfStatementAST::clone() const {
-    auto clonedCondition = unique_ptr<ExprAST>(dynamic_cast<ExprAST*>(condition->clone().release()));
+    auto clonedCondition = cloneAs(*condition);
     auto clonedThen = thenBody->clone();
     auto clonedElse = elseBody ? elseBody->clone() : nullptr;
     return make_unique<IfStatementAST>(move(clonedCondition), move(clonedThen), move(clonedElse));
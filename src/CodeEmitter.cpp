@@ -0,0 +1,14 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "CodeEmitter.h"
+
+#include <charconv>
+
+CodeEmitter& CodeEmitter::operator<<(const int value) {
+    char digits[16];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+    return *this;
+}
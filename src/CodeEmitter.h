@@ -0,0 +1,49 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef CODEEMITTER_H
+#define CODEEMITTER_H
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Growable output buffer the AST nodes append their C code to
+ *
+ * Replaces the strings returned and concatenated by every code() call : a whole module
+ * is generated in one buffer, then written to its file at once.
+ * The emitter also tracks the block depth, tab() writes the indentation of the current line.
+ */
+class CodeEmitter {
+    std::string buffer;
+    int depth = 0;
+
+public:
+    explicit CodeEmitter(size_t capacity = 0) { buffer.reserve(capacity); }
+
+    CodeEmitter& operator<<(const std::string_view text) {
+        buffer.append(text);
+        return *this;
+    }
+
+    CodeEmitter& operator<<(const char c) {
+        buffer.push_back(c);
+        return *this;
+    }
+
+    CodeEmitter& operator<<(int value);
+
+    CodeEmitter& tab() {
+        buffer.append(depth, '\t');
+        return *this;
+    }
+
+    void indent() { ++depth; }
+    void dedent() { if (depth > 0) --depth; }
+
+    [[nodiscard]] const std::string& str() const { return buffer; }
+    [[nodiscard]] size_t size() const { return buffer.size(); }
+    std::string take() { return std::move(buffer); }
+};
+
+#endif //CODEEMITTER_H
@@ -13,41 +13,43 @@
 
 
 // Should generate code for only 1 file
-string CodeGenerator::generate() const {
-    string code;
-
+void CodeGenerator::generate(CodeEmitter& out) const {
     // Implementation for defined methods
-    code += "\n// Methods and Constructors implementation:\n";
-    code += implementation;
-    code += "//\n\n";
+    out << "\n// Methods and Constructors implementation:\n";
+    out << implementation;
+    out << "//\n\n";
 
     // Handle the global block (per module)
-    if (const auto block = dynamic_cast<BlockAST*>(ast.get())) {
+    if (const auto block = ast_cast<BlockAST>(&ast)) {
         for (const auto& stmt : block->statements) {
             // Do not generate code for struct and extends (already done in header generation)
-            if (!dynamic_cast<StructDefinitionAST*>(stmt.get()) && !dynamic_cast<ExtendsStatementAST*>(stmt.get())) {
-                code += stmt->code();
+            if (stmt->kind != ASTKind::StructDefinition && stmt->kind != ASTKind::ExtendsStatement) {
+                stmt->emit(out);
             }
         }
     }
-    return code;
 }
 
 // TODO : generate constructor
 // Should be called before generate method
-string CodeGenerator::generateHeader() {
-    string headerCode;
+void CodeGenerator::generateHeader(CodeEmitter& out) {
     map<string, vector<string>> structFields;      // map de struct -> code des champs de base
     map<string, set<string>> allStructFields;      // map de struct -> code de TOUS les champs (héritage inclus)
     map<string, set<string>> structMethods;        // map de struct -> prototype des méthodes
     map<string, vector<string>> structCtors;       // map de struct -> prototype des constructeurs
+    // Structures in declaration order : an instantiation is declared after the ones its fields use
+    vector<string> structOrder;
 
     // --- PASS 1: Generate header for structs ---
-    if (const auto block = dynamic_cast<BlockAST*>(ast.get())) {
+    if (const auto block = ast_cast<BlockAST>(&ast)) {
         for (const auto& stmt : block->statements) {
-            if (const auto structDef = dynamic_cast<StructDefinitionAST*>(stmt.get())) {
+            const auto structDef = ast_cast<StructDefinitionAST>(stmt.get());
+            // A generic structure has no C type of its own, its instantiations are generated in 'generics'
+            if (structDef && structDef->genericParams.empty()) {
                 structFields.emplace(structDef->name, vector<string>());
-                allStructFields.emplace(structDef->name, set<string>());
+                if (allStructFields.emplace(structDef->name, set<string>()).second) {
+                    structOrder.push_back(structDef->name);
+                }
                 for (const auto& field : structDef->fields) {
                     string fieldCode = field->code();
                     structFields[structDef->name].push_back(field->type->type + " " + field->name);
@@ -59,12 +61,13 @@ string CodeGenerator::generateHeader() {
 
     // --- PASS 2: Generate header for extension (inheritance, methods, constructors) ---
     // FIXME : Gérer l'ordre d'héritage serait plus robuste (e.g., analyse topologique)
-    if (const auto block = dynamic_cast<BlockAST*>(ast.get())) {
+    if (const auto block = ast_cast<BlockAST>(&ast)) {
         for (const auto& stmt : block->statements) {
-            if (const auto ext = dynamic_cast<ExtendsStatementAST*>(stmt.get())) {
+            if (const auto ext = ast_cast<ExtendsStatementAST>(stmt.get())) {
                 // Assurer que les entrées existent
                 if (!allStructFields.contains(ext->structName)) {
                     allStructFields.emplace(ext->structName, set<string>());
+                    structOrder.push_back(ext->structName);
                 }
                 if (!structMethods.contains(ext->structName)) {
                     structMethods.emplace(ext->structName, set<string>());
@@ -75,6 +78,9 @@ string CodeGenerator::generateHeader() {
 
                 // Cas de l'héritage
                 if (!ext->parentStructName.empty()) {
+                    if (!allStructFields.contains(ext->parentStructName)) {
+                        structOrder.push_back(ext->parentStructName);
+                    }
                     for (const string& field : allStructFields[ext->parentStructName]) {
                         allStructFields[ext->structName].insert(field);
                     }
@@ -85,20 +91,29 @@ string CodeGenerator::generateHeader() {
 
                 // Add new members
                 for (auto& member : ext->members) {
-                    if (const auto var = dynamic_cast<VariableDeclarationAST*>(member.get())) {
-                        allStructFields[ext->structName].insert(var->code());
-                    } else if (const auto method = dynamic_cast<FunctionDefinitionAST*>(member.get())) {
-                        // C'est une méthode
-                        string proto = method->code(true);
-                        //implementation += proto;
-                        structMethods[ext->structName].insert(proto);
-                    } else if (const auto ctor = dynamic_cast<ConstructorDefinitionAST*>(member.get())) {
-                        // C'est un constructeur défini par l'utilisateur
-                        // Il faut lui passer le nom de la struct !
-                        ctor->structName = ext->structName;
-                        string proto = ctor->code();
-                        //implementation += proto;
-                        structCtors[ext->structName].push_back(proto);
+                    switch (member->kind) {
+                        case ASTKind::VariableDeclaration:
+                            allStructFields[ext->structName].insert(member->code());
+                            break;
+                        case ASTKind::FunctionDefinition: {
+                            // C'est une méthode
+                            string proto = static_cast<FunctionDefinitionAST*>(member.get())->code(true);
+                            //implementation += proto;
+                            structMethods[ext->structName].insert(proto);
+                            break;
+                        }
+                        case ASTKind::ConstructorDefinition: {
+                            // C'est un constructeur défini par l'utilisateur
+                            // Il faut lui passer le nom de la struct !
+                            const auto ctor = static_cast<ConstructorDefinitionAST*>(member.get());
+                            ctor->structName = ext->structName;
+                            string proto = ctor->code();
+                            //implementation += proto;
+                            structCtors[ext->structName].push_back(proto);
+                            break;
+                        }
+                        default:
+                            break;
                     }
                 }
             }
@@ -106,21 +121,21 @@ string CodeGenerator::generateHeader() {
     }
 
     // --- PASS 3: Generate structs definitions ---
-    for (const auto& [name, fields] : allStructFields) {
-        headerCode += "typedef struct {\n";
-        for (const string& field : fields) {
-            headerCode += '\t' + field + ";\n";
+    for (const string& name : structOrder) {
+        out << "typedef struct {\n";
+        for (const string& field : allStructFields[name]) {
+            out << '\t' << field << ";\n";
         }
-        headerCode += "} " + name + ";\n\n";
+        out << "} " << name << ";\n\n";
     }
 
     // --- PASS 4: Générer les prototypes (constructeurs et méthodes) ---
-    headerCode += "\n// Constructor prototypes\n";
+    out << "\n// Constructor prototypes\n";
     for (const auto& [name, protos] : structCtors) {
         // S'il y a des constructeurs customs, on les ajoute
         if (!protos.empty()) {
             for (const string& proto : protos) {
-                headerCode += proto.substr(0, proto.find('{')) + ";" + "\n";
+                out << string_view(proto).substr(0, proto.find('{')) << ";\n";
             }
         } else if (structFields.contains(name)) {
             // No constructor, fallback to default
@@ -161,18 +176,18 @@ string CodeGenerator::generateHeader() {
 
             ctorBody += "\treturn self;\n}\n";
 
-            headerCode += proto + "\n";
+            out << proto << "\n";
             implementation += ctorImpl + ctorBody;
         }
     }
 
-    headerCode += "\n// Method prototypes\n";
+    out << "\n// Method prototypes\n";
     for (const auto& [name, protos] : structMethods) {
         for (const string& proto : protos) {
             string tmp = proto;
             tmp.insert(tmp.find("fun"), name + "_");
             tmp.insert(tmp.find("* self"), name);
-            headerCode += tmp.substr(0, tmp.find('{')) + ";";
+            out << string_view(tmp).substr(0, tmp.find('{')) << ';';
 
             implementation += tmp + '\n';
             /*size_t pos = implementation.find(tmp);
@@ -180,8 +195,6 @@ string CodeGenerator::generateHeader() {
                 implementation.replace(pos, tmp.length(), tmp);
             }*/
         }
-        headerCode += "\n";
+        out << "\n";
     }
-
-    return headerCode;
 }
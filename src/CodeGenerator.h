@@ -10,13 +10,14 @@
 
 
 class CodeGenerator {
-    unique_ptr<AST> ast;
+    AST& ast; // Owned by the caller
     string implementation;
 public:
-    explicit CodeGenerator(unique_ptr<AST> ast) : ast(move(ast)) {}
+    explicit CodeGenerator(AST& ast) : ast(ast) {}
 
-    string generate() const;
-    string generateHeader();
+    // Both append to 'out', generateHeader must be called first
+    void generate(CodeEmitter& out) const;
+    void generateHeader(CodeEmitter& out);
 };
 
 
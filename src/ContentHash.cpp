@@ -0,0 +1,107 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ContentHash.h"
+
+#include <algorithm>
+#include <bit>
+
+static constexpr uint64_t C1 = 0x87c37b91114253d5;
+static constexpr uint64_t C2 = 0x4cf5ad432745937f;
+
+static uint64_t readLittleEndian(const uint8_t* bytes, const size_t size = 8) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        value |= static_cast<uint64_t>(bytes[i]) << i * 8;
+    }
+    return value;
+}
+
+static uint64_t mixK1(uint64_t k1) {
+    k1 *= C1;
+    k1 = std::rotl(k1, 31);
+    return k1 * C2;
+}
+
+static uint64_t mixK2(uint64_t k2) {
+    k2 *= C2;
+    k2 = std::rotl(k2, 33);
+    return k2 * C1;
+}
+
+static uint64_t finalMix(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccd;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53;
+    k ^= k >> 33;
+    return k;
+}
+
+void ContentHash::block(const uint8_t* data) {
+    h1 ^= mixK1(readLittleEndian(data));
+    h1 = std::rotl(h1, 27) + h2;
+    h1 = h1 * 5 + 0x52dce729;
+    h2 ^= mixK2(readLittleEndian(data + 8));
+    h2 = std::rotl(h2, 31) + h1;
+    h2 = h2 * 5 + 0x38495ab5;
+}
+
+void ContentHash::update(std::string_view data) {
+    length += data.size();
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    size_t size = data.size();
+    if (pendingSize > 0) {
+        const size_t taken = std::min(size, sizeof(pending) - pendingSize);
+        std::copy_n(bytes, taken, pending + pendingSize);
+        pendingSize += taken;
+        bytes += taken;
+        size -= taken;
+        if (pendingSize < sizeof(pending)) return;
+        block(pending);
+        pendingSize = 0;
+    }
+    for (; size >= sizeof(pending); bytes += sizeof(pending), size -= sizeof(pending)) {
+        block(bytes);
+    }
+    std::copy_n(bytes, size, pending);
+    pendingSize = size;
+}
+
+void ContentHash::add(const std::string_view data) {
+    update(data);
+    uint8_t size[8];
+    for (size_t i = 0; i < sizeof(size); i++) {
+        size[i] = static_cast<uint8_t>(static_cast<uint64_t>(data.size()) >> i * 8);
+    }
+    update({reinterpret_cast<const char*>(size), sizeof(size)});
+}
+
+std::string ContentHash::str() const {
+    uint64_t a = h1;
+    uint64_t b = h2;
+    // Tail : the bytes of the last, incomplete block
+    if (pendingSize > 8) {
+        b ^= mixK2(readLittleEndian(pending + 8, pendingSize - 8));
+    }
+    if (pendingSize > 0) {
+        a ^= mixK1(readLittleEndian(pending, std::min<size_t>(pendingSize, 8)));
+    }
+    a ^= length;
+    b ^= length;
+    a += b;
+    b += a;
+    a = finalMix(a);
+    b = finalMix(b);
+    a += b;
+    b += a;
+
+    static constexpr char Digits[] = "0123456789abcdef";
+    std::string hex(32, '0');
+    for (size_t i = 0; i < 16; i++) {
+        hex[15 - i] = Digits[a >> i * 4 & 0xF];
+        hex[31 - i] = Digits[b >> i * 4 & 0xF];
+    }
+    return hex;
+}
@@ -0,0 +1,35 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef CONTENTHASH_H
+#define CONTENTHASH_H
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Hash of file contents saved between compiles (see ObjectCache, BuildState)
+ *
+ * MurmurHash3 x64 128 (seed 0) of the added data, each field followed by its size as 8 little-endian
+ * bytes so "ab" + "c" and "a" + "bc" hash differently. The data is streamed through 16 bytes blocks,
+ * bytes are read one by one : the hash is stable across runs and platforms.
+ */
+class ContentHash {
+    uint64_t h1 = 0;
+    uint64_t h2 = 0;
+    uint8_t pending[16] {}; // Start of the next block
+    size_t pendingSize = 0;
+    uint64_t length = 0;    // Bytes hashed so far
+
+    void block(const uint8_t* data);
+    void update(std::string_view data);
+public:
+    void add(std::string_view data);
+
+    // 32 hexadecimal digits, the data can still be added to afterwards
+    [[nodiscard]] std::string str() const;
+};
+
+#endif //CONTENTHASH_H
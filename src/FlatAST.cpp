@@ -0,0 +1,414 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "FlatAST.h"
+
+#include "Logger.h"
+
+namespace {
+    // Appends an empty node, filled once its children are added
+    template <typename T>
+    NodeIndex slot(vector<T>& nodes) {
+        nodes.emplace_back();
+        return static_cast<NodeIndex>(nodes.size() - 1);
+    }
+
+    template <typename T>
+    IndexRange reserve(vector<T>& nodes, const size_t count) {
+        const IndexRange range {static_cast<uint32_t>(nodes.size()), static_cast<uint32_t>(count)};
+        nodes.resize(nodes.size() + count);
+        return range;
+    }
+}
+
+FlatAST::FlatAST(const BlockAST& module) {
+    root = add(&module).index;
+}
+
+template <typename Node>
+IndexRange FlatAST::addRefs(const vector<unique_ptr<Node>>& nodes) {
+    const IndexRange range = reserve(refs, nodes.size());
+    for (uint32_t i = 0; i < range.count; i++) {
+        const NodeRef ref = add(nodes[i].get());
+        refs[range.begin + i] = ref;
+    }
+    return range;
+}
+
+NodeIndex FlatAST::addType(const TypeAST& type) {
+    const NodeIndex index = slot(types);
+    fillType(index, type);
+    return index;
+}
+
+void FlatAST::fillType(const NodeIndex index, const TypeAST& type) {
+    const IndexRange args = reserve(types, type.genericArgs.size());
+    for (uint32_t i = 0; i < args.count; i++) {
+        fillType(args.begin + i, *type.genericArgs[i]);
+    }
+    const NodeRef size = add(type.arraySize.get());
+    types[index] = {type.type, args, type.isArray, size};
+}
+
+void FlatAST::fillParameter(const NodeIndex index, const FunctionParameterAST& param) {
+    const NodeIndex type = addType(*param.type);
+    parameters[index] = {type, param.name};
+}
+
+IndexRange FlatAST::addParameters(const vector<unique_ptr<FunctionParameterAST>>& params) {
+    const IndexRange range = reserve(parameters, params.size());
+    for (uint32_t i = 0; i < range.count; i++) {
+        fillParameter(range.begin + i, *params[i]);
+    }
+    return range;
+}
+
+NodeRef FlatAST::add(const AST* node) {
+    if (!node) {
+        return {};
+    }
+    NodeIndex index = NoNode;
+    switch (node->kind) {
+        case ASTKind::Block: {
+            index = slot(blocks);
+            const IndexRange statements = addRefs(static_cast<const BlockAST*>(node)->statements);
+            blocks[index] = {statements};
+            break;
+        }
+        case ASTKind::ExternStatement:
+            index = slot(externStatements);
+            externStatements[index] = static_cast<const ExternStatementAST*>(node)->libraryName;
+            break;
+        case ASTKind::Type:
+            index = addType(*static_cast<const TypeAST*>(node));
+            break;
+        case ASTKind::FunctionParameter:
+            index = slot(parameters);
+            fillParameter(index, *static_cast<const FunctionParameterAST*>(node));
+            break;
+        case ASTKind::FunctionDefinition: {
+            const auto* function = static_cast<const FunctionDefinitionAST*>(node);
+            index = slot(functions);
+            const NodeIndex returnType = addType(*function->returnType);
+            const IndexRange params = addParameters(function->params);
+            const NodeRef body = add(function->body.get());
+            functions[index] = {returnType, function->name, params, body, function->isStatic};
+            break;
+        }
+        case ASTKind::VariableDeclaration: {
+            const auto* declaration = static_cast<const VariableDeclarationAST*>(node);
+            index = slot(declarations);
+            const NodeIndex type = addType(*declaration->type);
+            const NodeRef initializer = add(declaration->initializer.get());
+            declarations[index] = {type, declaration->name, initializer};
+            break;
+        }
+        case ASTKind::GenericParameter:
+            index = slot(genericParams);
+            genericParams[index] = static_cast<const GenericParameterAST*>(node)->name;
+            break;
+        case ASTKind::StructField: {
+            const auto* field = static_cast<const StructFieldAST*>(node);
+            index = slot(fields);
+            const NodeIndex type = addType(*field->type);
+            fields[index] = {type, field->name};
+            break;
+        }
+        case ASTKind::StructDefinition: {
+            const auto* structDef = static_cast<const StructDefinitionAST*>(node);
+            index = slot(structs);
+            const IndexRange generics = reserve(genericParams, structDef->genericParams.size());
+            for (uint32_t i = 0; i < generics.count; i++) {
+                genericParams[generics.begin + i] = structDef->genericParams[i]->name;
+            }
+            const IndexRange structFields = reserve(fields, structDef->fields.size());
+            for (uint32_t i = 0; i < structFields.count; i++) {
+                const NodeIndex type = addType(*structDef->fields[i]->type);
+                fields[structFields.begin + i] = {type, structDef->fields[i]->name};
+            }
+            structs[index] = {structDef->name, generics, structFields};
+            break;
+        }
+        case ASTKind::ConstructorDefinition: {
+            const auto* ctor = static_cast<const ConstructorDefinitionAST*>(node);
+            index = slot(constructors);
+            const IndexRange params = addParameters(ctor->params);
+            const NodeRef body = add(ctor->body.get());
+            constructors[index] = {ctor->structName, params, body};
+            break;
+        }
+        case ASTKind::ExtendsStatement: {
+            const auto* ext = static_cast<const ExtendsStatementAST*>(node);
+            index = slot(extends);
+            const IndexRange members = addRefs(ext->members);
+            extends[index] = {ext->structName, ext->parentStructName, members};
+            break;
+        }
+        case ASTKind::Return: {
+            index = slot(returns);
+            const NodeRef value = add(static_cast<const ReturnAST*>(node)->value.get());
+            returns[index] = {value};
+            break;
+        }
+        case ASTKind::IfStatement: {
+            const auto* ifStmt = static_cast<const IfStatementAST*>(node);
+            index = slot(ifs);
+            const NodeRef condition = add(ifStmt->condition.get());
+            const NodeRef thenBody = add(ifStmt->thenBody.get());
+            const NodeRef elseBody = add(ifStmt->elseBody.get());
+            ifs[index] = {condition, thenBody, elseBody};
+            break;
+        }
+        case ASTKind::FloatExpr:
+            index = slot(floats);
+            floats[index] = static_cast<const FloatExprAST*>(node)->val;
+            break;
+        case ASTKind::IntExpr:
+            index = slot(ints);
+            ints[index] = static_cast<const IntExprAST*>(node)->val;
+            break;
+        case ASTKind::StringExpr:
+            index = slot(strings);
+            strings[index] = static_cast<const StringExprAST*>(node)->val;
+            break;
+        case ASTKind::VariableExpr: {
+            const auto* variable = static_cast<const VariableExprAST*>(node);
+            index = slot(variables);
+            variables[index] = {variable->name, variable->isField, {}};
+            break;
+        }
+        case ASTKind::FieldAccess: {
+            const auto* access = static_cast<const FieldAccessAST*>(node);
+            index = slot(fieldAccesses);
+            const NodeRef owner = add(access->ownerExpr.get());
+            fieldAccesses[index] = {access->name, access->isField, owner};
+            break;
+        }
+        case ASTKind::OperationExpr: {
+            const auto* operation = static_cast<const OperationExprAST*>(node);
+            index = slot(operations);
+            const NodeRef lhs = add(operation->LHS.get());
+            const NodeRef rhs = add(operation->RHS.get());
+            operations[index] = {operation->op, lhs, rhs};
+            break;
+        }
+        case ASTKind::FunctionCall: {
+            const auto* call = static_cast<const FunctionCallAST*>(node);
+            index = slot(calls);
+            const IndexRange args = addRefs(call->params);
+            calls[index] = {call->name, call->signature, args, {}};
+            break;
+        }
+        case ASTKind::MethodCall: {
+            const auto* call = static_cast<const MethodCallAST*>(node);
+            index = slot(methodCalls);
+            const NodeRef owner = add(call->ownerExpr.get());
+            const IndexRange args = addRefs(call->params);
+            methodCalls[index] = {call->name, call->signature, args, owner};
+            break;
+        }
+        case ASTKind::VariableAssignment: {
+            const auto* assignment = static_cast<const VariableAssignmentAST*>(node);
+            index = slot(assignments);
+            const NodeRef target = add(assignment->target.get());
+            const NodeRef value = add(assignment->value.get());
+            assignments[index] = {target, value, assignment->accessor};
+            break;
+        }
+        case ASTKind::ExternExpr:
+            index = slot(externExprs);
+            externExprs[index] = static_cast<const ExternExprAST*>(node)->body;
+            break;
+    }
+    return {node->kind, index};
+}
+
+unique_ptr<BlockAST> FlatAST::toTree() const {
+    return unique_ptr<BlockAST>(static_cast<BlockAST*>(build({ASTKind::Block, root}).release()));
+}
+
+unique_ptr<TypeAST> FlatAST::buildType(const NodeIndex index) const {
+    const Type& type = types[index];
+    vector<unique_ptr<TypeAST>> args;
+    args.reserve(type.genericArgs.count);
+    for (uint32_t i = type.genericArgs.begin; i < type.genericArgs.end(); i++) {
+        args.push_back(buildType(i));
+    }
+    auto result = make_unique<TypeAST>(type.name, move(args));
+    result->isArray = type.isArray;
+    result->arraySize = buildExpr(type.arraySize);
+    return result;
+}
+
+vector<unique_ptr<FunctionParameterAST>> FlatAST::buildParameters(const IndexRange range) const {
+    vector<unique_ptr<FunctionParameterAST>> params;
+    params.reserve(range.count);
+    for (uint32_t i = range.begin; i < range.end(); i++) {
+        params.push_back(make_unique<FunctionParameterAST>(buildType(parameters[i].type), parameters[i].name));
+    }
+    return params;
+}
+
+unique_ptr<ExprAST> FlatAST::buildExpr(const NodeRef ref) const {
+    return unique_ptr<ExprAST>(static_cast<ExprAST*>(build(ref).release()));
+}
+
+unique_ptr<AST> FlatAST::build(const NodeRef ref) const {
+    if (!ref.valid()) {
+        return nullptr;
+    }
+    const NodeIndex i = ref.index;
+    switch (ref.kind) {
+        case ASTKind::Block: {
+            vector<unique_ptr<AST>> statements;
+            statements.reserve(blocks[i].statements.count);
+            for (uint32_t s = blocks[i].statements.begin; s < blocks[i].statements.end(); s++) {
+                statements.push_back(build(refs[s]));
+            }
+            return make_unique<BlockAST>(move(statements));
+        }
+        case ASTKind::ExternStatement:
+            return make_unique<ExternStatementAST>(externStatements[i]);
+        case ASTKind::Type:
+            return buildType(i);
+        case ASTKind::FunctionParameter:
+            return make_unique<FunctionParameterAST>(buildType(parameters[i].type), parameters[i].name);
+        case ASTKind::FunctionDefinition: {
+            const FunctionDefinition& function = functions[i];
+            return make_unique<FunctionDefinitionAST>(buildType(function.returnType), function.name,
+                buildParameters(function.params), build(function.body), function.isStatic);
+        }
+        case ASTKind::VariableDeclaration: {
+            const VariableDeclaration& declaration = declarations[i];
+            return make_unique<VariableDeclarationAST>(buildType(declaration.type), declaration.name, buildExpr(declaration.initializer));
+        }
+        case ASTKind::GenericParameter:
+            return make_unique<GenericParameterAST>(genericParams[i]);
+        case ASTKind::StructField:
+            return make_unique<StructFieldAST>(buildType(fields[i].type), fields[i].name);
+        case ASTKind::StructDefinition: {
+            const StructDefinition& structDef = structs[i];
+            vector<unique_ptr<GenericParameterAST>> generics;
+            for (uint32_t g = structDef.genericParams.begin; g < structDef.genericParams.end(); g++) {
+                generics.push_back(make_unique<GenericParameterAST>(genericParams[g]));
+            }
+            vector<unique_ptr<StructFieldAST>> structFields;
+            for (uint32_t f = structDef.fields.begin; f < structDef.fields.end(); f++) {
+                structFields.push_back(make_unique<StructFieldAST>(buildType(fields[f].type), fields[f].name));
+            }
+            return make_unique<StructDefinitionAST>(structDef.name, move(generics), move(structFields));
+        }
+        case ASTKind::ConstructorDefinition: {
+            const ConstructorDefinition& ctor = constructors[i];
+            return make_unique<ConstructorDefinitionAST>(ctor.structName, buildParameters(ctor.params), build(ctor.body));
+        }
+        case ASTKind::ExtendsStatement: {
+            const ExtendsStatement& ext = extends[i];
+            vector<unique_ptr<AST>> members;
+            for (uint32_t m = ext.members.begin; m < ext.members.end(); m++) {
+                members.push_back(build(refs[m]));
+            }
+            return make_unique<ExtendsStatementAST>(ext.structName, ext.parentStructName, move(members));
+        }
+        case ASTKind::Return:
+            return make_unique<ReturnAST>(buildExpr(returns[i].value));
+        case ASTKind::IfStatement:
+            return make_unique<IfStatementAST>(buildExpr(ifs[i].condition), build(ifs[i].thenBody), build(ifs[i].elseBody));
+        case ASTKind::FloatExpr:
+            return make_unique<FloatExprAST>(floats[i]);
+        case ASTKind::IntExpr:
+            return make_unique<IntExprAST>(ints[i]);
+        case ASTKind::StringExpr:
+            return make_unique<StringExprAST>(strings[i]);
+        case ASTKind::VariableExpr: {
+            auto variable = make_unique<VariableExprAST>(variables[i].name);
+            variable->isField = variables[i].isField;
+            return variable;
+        }
+        case ASTKind::FieldAccess: {
+            auto access = make_unique<FieldAccessAST>(buildExpr(fieldAccesses[i].owner), fieldAccesses[i].name);
+            access->isField = fieldAccesses[i].isField;
+            return access;
+        }
+        case ASTKind::OperationExpr:
+            return make_unique<OperationExprAST>(operations[i].op, buildExpr(operations[i].lhs), buildExpr(operations[i].rhs));
+        case ASTKind::FunctionCall:
+        case ASTKind::MethodCall: {
+            const Call& call = ref.kind == ASTKind::FunctionCall ? calls[i] : methodCalls[i];
+            vector<unique_ptr<ExprAST>> args;
+            args.reserve(call.args.count);
+            for (uint32_t a = call.args.begin; a < call.args.end(); a++) {
+                args.push_back(buildExpr(refs[a]));
+            }
+            unique_ptr<FunctionCallAST> result;
+            if (ref.kind == ASTKind::MethodCall) {
+                result = make_unique<MethodCallAST>(buildExpr(call.owner), call.name, move(args));
+            } else {
+                result = make_unique<FunctionCallAST>(call.name, move(args));
+            }
+            result->signature = call.signature;
+            return result;
+        }
+        case ASTKind::VariableAssignment: {
+            auto assignment = make_unique<VariableAssignmentAST>(buildExpr(assignments[i].target), buildExpr(assignments[i].value));
+            assignment->accessor = assignments[i].accessor;
+            return assignment;
+        }
+        case ASTKind::ExternExpr:
+            return make_unique<ExternExprAST>(externExprs[i]);
+    }
+    return nullptr;
+}
+
+string FlatAST::signature(const FunctionDefinition& function) const {
+    string signature = (function.name != "main" ? "fun_" : "") + function.name;
+    for (uint32_t i = function.params.begin; i < function.params.end(); i++) {
+        signature += '_' + types[parameters[i].type].name;
+    }
+    return signature;
+}
+
+void FlatAST::prePass(SymbolTable& table) const {
+    const IndexRange statements = blocks[root].statements;
+    for (uint32_t i = statements.begin; i < statements.end(); i++) {
+        const NodeRef ref = refs[i];
+        if (ref.kind == ASTKind::FunctionDefinition) {
+            const FunctionDefinition& function = functions[ref.index];
+            TypeTable& typeTable = TypeTable::Global();
+            Overload overload{{}, {.type = typeTable.intern(types[function.returnType].name)}, signature(function)};
+            for (uint32_t param = function.params.begin; param < function.params.end(); param++) {
+                overload.params.push_back(typeTable.intern(types[parameters[param].type].name));
+            }
+            if (!table.addOverload(TypeTable::None, NameTable::Global().intern(function.name), overload)) {
+                Logger::Error("Function '" + function.name + "' already defined. (signature : "+overload.cName+").");
+            }
+        } else if (ref.kind == ASTKind::StructDefinition) {
+            const string& name = structs[ref.index].name;
+            if (!table.addSymbol(name, {TypeTable::Global().intern(name), SymbolInfo::Structure})) {
+                Logger::Error("Structure '" + name + "' already defined.");
+            }
+        }
+    }
+}
+
+void FlatAST::substitute(const map<string, unique_ptr<TypeAST>>& typeMap) {
+    // Clear all generics parameters
+    for (auto& structDef : structs) {
+        structDef.genericParams = {};
+    }
+    // Types appended by a replacement are concrete, they are not scanned
+    const auto count = static_cast<NodeIndex>(types.size());
+    for (NodeIndex i = 0; i < count; i++) {
+        if (const auto it = typeMap.find(types[i].name); it != typeMap.end()) {
+            fillType(i, *it->second);
+        }
+    }
+}
+
+size_t FlatAST::nodeCount() const {
+    return blocks.size() + types.size() + parameters.size() + functions.size() + calls.size() + methodCalls.size()
+         + variables.size() + fieldAccesses.size() + operations.size() + declarations.size() + assignments.size()
+         + fields.size() + structs.size() + constructors.size() + extends.size() + returns.size() + ifs.size()
+         + floats.size() + ints.size() + strings.size() + externExprs.size() + externStatements.size() + genericParams.size();
+}
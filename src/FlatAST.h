@@ -0,0 +1,137 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef FLATAST_H
+#define FLATAST_H
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AST.h"
+
+using namespace std;
+
+using NodeIndex = uint32_t;
+constexpr NodeIndex NoNode = UINT32_MAX;
+
+// Node of any kind : the kind selects the array, the index the element in it
+struct NodeRef {
+    ASTKind kind = ASTKind::Block;
+    NodeIndex index = NoNode;
+
+    [[nodiscard]] bool valid() const { return index != NoNode; }
+};
+
+// Children stored contiguously in one of the FlatAST arrays
+struct IndexRange {
+    uint32_t begin = 0;
+    uint32_t count = 0;
+
+    [[nodiscard]] uint32_t end() const { return begin + count; }
+};
+
+/**
+ * @brief Data-oriented copy of a module AST
+ *
+ * Nodes live in one contiguous array per kind and refer to each other with 32-bit indices,
+ * children lists are ranges into an array : 'refs' for lists of mixed kinds, the array of the
+ * child kind otherwise (parameters, fields, generic arguments).
+ * The children of a node are reserved before being filled, so they stay contiguous and always
+ * come after their parent in their array.
+ *
+ * Passes that only care about one kind of node become a linear scan over its array
+ * (see substitute), instead of a walk through the whole pointer tree.
+ */
+class FlatAST {
+public:
+    struct Block { IndexRange statements; };                     // refs
+    struct Type {
+        string name;
+        IndexRange genericArgs;                                   // types
+        bool isArray = false;
+        NodeRef arraySize;
+    };
+    struct FunctionParameter { NodeIndex type; string name; };
+    struct FunctionDefinition {
+        NodeIndex returnType;
+        string name;
+        IndexRange params;                                        // parameters
+        NodeRef body;
+        bool isStatic;
+    };
+    struct Call { string name; string signature; IndexRange args; NodeRef owner; }; // refs, owner for methods
+    struct Variable { string name; bool isField; NodeRef owner; };                  // owner for field accesses
+    struct Operation { TokenType op; NodeRef lhs, rhs; };
+    struct VariableDeclaration { NodeIndex type; string name; NodeRef initializer; };
+    struct Assignment { NodeRef target, value; string accessor; };
+    struct StructField { NodeIndex type; string name; };
+    struct StructDefinition {
+        string name;
+        IndexRange genericParams;                                 // genericParams
+        IndexRange fields;                                        // fields
+    };
+    struct ConstructorDefinition { string structName; IndexRange params; NodeRef body; }; // parameters
+    struct ExtendsStatement { string structName, parentStructName; IndexRange members; }; // refs
+    struct Return { NodeRef value; };
+    struct IfStatement { NodeRef condition, thenBody, elseBody; };
+
+    vector<NodeRef> refs;
+    vector<Block> blocks;
+    vector<Type> types;
+    vector<FunctionParameter> parameters;
+    vector<FunctionDefinition> functions;
+    vector<Call> calls;
+    vector<Call> methodCalls;
+    vector<Variable> variables;
+    vector<Variable> fieldAccesses;
+    vector<Operation> operations;
+    vector<VariableDeclaration> declarations;
+    vector<Assignment> assignments;
+    vector<StructField> fields;
+    vector<StructDefinition> structs;
+    vector<ConstructorDefinition> constructors;
+    vector<ExtendsStatement> extends;
+    vector<Return> returns;
+    vector<IfStatement> ifs;
+    vector<float> floats;
+    vector<int> ints;
+    vector<string> strings;
+    vector<string> externExprs;         // Body of the extern blocks
+    vector<string> externStatements;    // Imported library names
+    vector<string> genericParams;
+
+    NodeIndex root = NoNode; // Module block
+
+    explicit FlatAST(const BlockAST& module);
+
+    // Back to the pointer tree, allocated in the current ASTArena
+    [[nodiscard]] unique_ptr<BlockAST> toTree() const;
+
+    // Same symbols as BlockAST::prePass : hoists the top-level functions and structures
+    void prePass(SymbolTable& table) const;
+
+    // Same result as substitute_recursive on the whole module, as one scan over the types
+    void substitute(const map<string, unique_ptr<TypeAST>>& typeMap);
+
+    [[nodiscard]] size_t nodeCount() const;
+
+private:
+    NodeRef add(const AST* node);
+    NodeIndex addType(const TypeAST& type);
+    void fillType(NodeIndex index, const TypeAST& type);
+    void fillParameter(NodeIndex index, const FunctionParameterAST& param);
+    IndexRange addParameters(const vector<unique_ptr<FunctionParameterAST>>& params);
+    template <typename Node>
+    IndexRange addRefs(const vector<unique_ptr<Node>>& nodes);
+
+    [[nodiscard]] unique_ptr<AST> build(NodeRef ref) const;
+    [[nodiscard]] unique_ptr<ExprAST> buildExpr(NodeRef ref) const;
+    [[nodiscard]] unique_ptr<TypeAST> buildType(NodeIndex index) const;
+    [[nodiscard]] vector<unique_ptr<FunctionParameterAST>> buildParameters(IndexRange range) const;
+    [[nodiscard]] string signature(const FunctionDefinition& function) const;
+};
+
+#endif //FLATAST_H
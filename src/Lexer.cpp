@@ -4,82 +4,16 @@
 
 #include "Lexer.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <utility>
 
+#include "LexerScan.h"
 #include "Logger.h"
+#include "TokenTable.h"
 
 std::string tokenToString(const TokenType& token) {
-    switch (token) {
-        case TokenType::T_ID: return "ID";
-        case TokenType::T_Comma: return ",";
-        case TokenType::T_Semicolon: return ";";
-        case TokenType::T_Dot: return ".";
-        case TokenType::T_Int: return "Int";
-        case TokenType::T_String: return "String";
-
-        case TokenType::T_Assign: return "=";
-        case TokenType::T_Increment: return "++";
-        case TokenType::T_Decrement: return "--";
-        case TokenType::T_AddAssign: return "+=";
-        case TokenType::T_SubAssign: return "-=";
-        case TokenType::T_MulAssign: return "*=";
-        case TokenType::T_DivAssign: return "/=";
-        case TokenType::T_ModAssign: return "%=";
-        case TokenType::T_AndAssign: return "&=";
-        case TokenType::T_XorAssign: return "^=";
-        case TokenType::T_OrAssign: return "|=";
-        case TokenType::T_LShiftAssign: return "<<=";
-        case TokenType::T_RShiftAssign: return ">>=";
-
-        case TokenType::T_Mul: return "*";
-        case TokenType::T_Div: return "/";
-        case TokenType::T_Mod: return "%";
-        case TokenType::T_Add: return "+";
-        case TokenType::T_Sub: return "-";
-
-        case TokenType::T_Not: return "!";
-        case TokenType::T_Complement: return "~";
-        case TokenType::T_LBitShift: return "<<";
-        case TokenType::T_RBitShift: return ">>";
-        case TokenType::T_BitAND: return "&";
-        case TokenType::T_BitOR: return "|";
-        case TokenType::T_BitXOR: return "^";
-        case TokenType::T_LogOR: return "||";
-        case TokenType::T_LogAND: return "&&";
-
-        case TokenType::T_GT: return ">";
-        case TokenType::T_GE: return ">=";
-        case TokenType::T_LT: return "<";
-        case TokenType::T_LE: return "<=";
-        case TokenType::T_Equals: return "==";
-        case TokenType::T_NotEquals: return "!=";
-
-        case TokenType::T_LParen: return "(";
-        case TokenType::T_RParen: return ")";
-        case TokenType::T_LBrace: return "{";
-        case TokenType::T_RBrace: return "}";
-        case TokenType::T_LBracket: return "[";
-        case TokenType::T_RBracket: return "]";
-
-        case TokenType::T_EOF: return "EOF";
-        default: return "ERROR";
-    }
-}
-
-void Lexer::initKeywords() {
-    keywords["extern"] = TokenType::T_Extern;
-    keywords["struct"] = TokenType::T_Struct;
-    keywords["extends"] = TokenType::T_Extends;
-    keywords["constructor"] = TokenType::T_Constructor;
-    keywords["return"] = TokenType::T_Return;
-    keywords["for"] = TokenType::T_For;
-    keywords["while"] = TokenType::T_While;
-    keywords["break"] = TokenType::T_Break;
-    keywords["continue"] = TokenType::T_Continue;
-    keywords["if"] = TokenType::T_If;
-    keywords["else"] = TokenType::T_Else;
-    keywords["static"] = TokenType::T_Static;
+    return std::string(tokenInfo(token).spelling);
 }
 
 char Lexer::peek(const int offset) const {
@@ -103,78 +37,119 @@ char Lexer::advance() {
     return c;
 }
 
+// Skips a span known to contain no newline
+void Lexer::advanceColumns(const size_t length) {
+    current_pos += length;
+    current_column += static_cast<int>(length);
+}
+
+// Skips 'length' bytes of any text, keeping the line and column in sync
+void Lexer::advanceText(const size_t length) {
+    const char* end = source.data() + current_pos + length;
+    const char* p = source.data() + current_pos;
+    while (const auto* newline = static_cast<const char*>(std::memchr(p, '\n', end - p))) {
+        current_line++;
+        p = newline + 1;
+    }
+    if (p != source.data() + current_pos) {
+        current_column = 1; // At least one newline
+    }
+    current_column += static_cast<int>(end - p);
+    current_pos += length;
+}
+
 void Lexer::skipWhitespace() {
-    while (current_pos < source.length() && std::isspace(peek())) {
-        advance();
+    const char* begin = source.data() + current_pos;
+    const WhitespaceSpan span = scan::whitespace(begin, source.data() + source.length());
+    if (span.newlines == 0) {
+        advanceColumns(span.length);
+        return;
     }
+    // Position is deduced from the newlines count, the column restarts after the last one
+    current_pos += span.length;
+    current_line += static_cast<int>(span.newlines);
+    current_column = static_cast<int>(span.length - span.lastNewline);
 }
 
-Token Lexer::createToken(const TokenType type, const std::string& value, const int startCol) const {
+Token Lexer::createToken(const TokenType type, const std::string_view value, const int startCol) const {
     return {type, value, current_line, (startCol != -1) ? startCol : current_column - static_cast<int>(value.length())};
 }
 
+// Text consumed since 'start', as a view into the source buffer
+std::string_view Lexer::slice(const size_t start) const {
+    return source.substr(start, current_pos - start);
+}
+
 Token Lexer::matchKeywordOrIdentifier(const int startCol) {
-    std::string value;
-    if (std::isalpha(peek())) {
-        value += advance();
-        while (std::isalnum(peek()) || peek() == '_') {
-            value += advance();
-        }
-    }
-    // Check if it's a keyword
-    if (keywords.contains(value)) {
-        return createToken(keywords[value], value, startCol);
-    }
-    return createToken(TokenType::T_ID, value, startCol);
+    const size_t start = current_pos;
+    advanceColumns(scan::identifier(source.data() + current_pos, source.data() + source.length()));
+    const std::string_view value = slice(start);
+    // Keywords are found with a compile-time perfect hash, anything else is an identifier
+    return createToken(lookupKeyword(value), value, startCol);
 }
 
 Token Lexer::matchNumber(const int startCol) {
-    std::string value;
+    const size_t start = current_pos;
+    const char* end = source.data() + source.length();
     bool isFloat = false;
-    while (std::isdigit(peek())) {
-        value += advance();
-    }
+    advanceColumns(scan::digits(source.data() + current_pos, end));
     if (peek() == '.') {
         isFloat = true;
-        value += advance();
-        while (std::isdigit(peek())) {
-            value += advance();
-        }
+        advance();
+        advanceColumns(scan::digits(source.data() + current_pos, end));
     }
-    return createToken(isFloat ? TokenType::T_Float :TokenType::T_Int, value, startCol);
+    return createToken(isFloat ? TokenType::T_Float :TokenType::T_Int, slice(start), startCol);
 }
 
 Token Lexer::matchString(int startCol) {
-    std::string value;
     advance(); // eat the first "
-    while (peek() != '"' && peek() != '\0') {
-        value += advance();
-    }
+    const size_t start = current_pos;
+    const size_t end = std::min(source.find_first_of(std::string_view("\"\0", 2), current_pos), source.length());
+    advanceText(end - start);
+    const std::string_view value = slice(start);
     if (peek() == '\0') {
-        std::cerr << "Error: Unclosed string literal at line " << current_line << ", column " << startCol << std::endl;
+        report("Error: Unclosed string literal at line " + std::to_string(current_line) + ", column " + std::to_string(startCol));
         return createToken(TokenType::T_EOF, value, startCol);
     }
     advance(); // eat the last "
     return createToken(TokenType::T_String, value, startCol);
 }
 
-Lexer::Lexer(std::string in) {
-    source = std::move(in);
-    initKeywords();
+Lexer::Lexer(const std::string_view in) : source(in) {}
+
+Lexer::Lexer(const std::string_view in, const size_t offset, const int line, const int column, const bool speculative) :
+    source(in), current_pos(offset), current_line(line), current_column(column), speculative(speculative) {}
+
+// Prints a lexing error, a speculative lexer fails instead
+void Lexer::report(const std::string& message) {
+    if (speculative) {
+        failed = true;
+        return;
+    }
+    Logger::Write(message + '\n');
 }
 
 std::vector<Token> Lexer::tokenize() {
     std::vector<Token> out;
-    Token current;
+    out.reserve(source.length() / 8); // Rough token density, avoids most regrowth
+    do {
+        out.push_back(next());
+    } while (!finished);
+    return out;
+}
 
-    while (current_pos < source.length()) {
+Token Lexer::next() {
+    while (true) {
         skipWhitespace();
         if (current_pos >= source.length()) {
-            break;
+            finished = true;
+            return createToken(TokenType::T_EOF, "EOF", current_column);
         }
 
+        tokenStart = current_pos;
         int tokenStartCol = current_column;
         char c = peek();
+        Token current{TokenType::T_Error};
 
         // Identifiers, strings and numbers
         if (std::isalpha(c) || c == '_') {
@@ -193,6 +168,8 @@ std::vector<Token> Lexer::tokenize() {
                     if (peek() == ':') {
                         advance();
                         current = createToken(TokenType::T_StaticCall, "::", tokenStartCol);
+                    } else {
+                        report("Unexpected character found: ':' at line " + std::to_string(current_line) + ", column " + std::to_string(tokenStartCol));
                     }
                     break;
                 }
@@ -248,21 +225,15 @@ std::vector<Token> Lexer::tokenize() {
                         advance();
                         current = createToken(TokenType::T_DivAssign, "/=", tokenStartCol);
                     } else if (peek() == '/') {
-                        do {
-                            advance();
-                        } while (peek() != '\n' && current_pos < source.length());
+                        // Skip until the end of the line (the '\n' is left to skipWhitespace)
+                        const size_t end = std::min(source.find('\n', current_pos), source.length());
+                        advanceColumns(end - current_pos);
                         continue;
                     } else if (peek() == '*') {
                         advance(); // eat '*'
                         // Search for '*/'
-                        while (current_pos < source.length()) {
-                            if (peek() == '*' && peek(1) == '/') {
-                                advance(); // eat '*'
-                                advance(); // eat '/'
-                                break;
-                            }
-                            advance();
-                        }
+                        const size_t end = source.find("*/", current_pos);
+                        advanceText(end == std::string_view::npos ? source.length() - current_pos : end + 2 - current_pos);
                         continue;
                     } else {
                         current = createToken(TokenType::T_Div, "/", tokenStartCol);
@@ -376,9 +347,9 @@ std::vector<Token> Lexer::tokenize() {
                 case '.': advance(); current = createToken(TokenType::T_Dot, ".", tokenStartCol); break;
                 case ',': advance(); current = createToken(TokenType::T_Comma, ",", tokenStartCol); break;
                 default:
-                    std::cerr << "Unexpected character found: '" << c << "' at line " << current_line << ", column " << current_column << std::endl;
+                    report(std::string("Unexpected character found: '") + c + "' at line " + std::to_string(current_line) + ", column " + std::to_string(current_column));
                     advance();
-                    current = createToken(TokenType::T_Error, std::string(1, c), tokenStartCol);
+                    current = createToken(TokenType::T_Error, source.substr(current_pos - 1, 1), tokenStartCol);
                     break;
             }
         }
@@ -389,26 +360,35 @@ std::vector<Token> Lexer::tokenize() {
             if (peek(0) == '{') {
                 advance();
                 unsigned int counter = 1;
-                std::string ffi;
+                const size_t ffiStart = current_pos;
                 while (counter > 0) {
-                    ffi += advance();
+                    advance();
                     if (peek(0) == '}') counter--;
                     if (peek(0) == '{') counter++;
                     if (peek(0) == '\0') {
+                        if (speculative) {
+                            failed = true;
+                            break;
+                        }
                         Logger::Error("Expected end of 'extern' block.");
-                        exit(EXIT_FAILURE);
+                        throw SyntaxError();
                     }
                 }
-                advance();
-                out.push_back(createToken(TokenType::T_Extern, ffi, current_column));
-                continue;
+                if (!failed) {
+                    const std::string_view ffi = slice(ffiStart);
+                    advance();
+                    return createToken(TokenType::T_Extern, ffi, current_column);
+                }
             }
         }
-        // Push token if no error
+        // A speculative lexer gives up at the first error
+        if (failed) {
+            finished = true;
+            return createToken(TokenType::T_EOF, "EOF", current_column);
+        }
+        // Errors are reported and skipped
         if (current.type != TokenType::T_Error) {
-            out.push_back(current);
+            return current;
         }
     }
-    out.push_back(createToken(TokenType::T_EOF, "EOF", current_column));
-    return out;
 }
@@ -4,8 +4,8 @@
 
 #ifndef LEXER_H
 #define LEXER_H
-#include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 enum class TokenType {
@@ -79,35 +79,59 @@ enum class TokenType {
     T_Error,
 };
 
+// Tokens do not own their text : value is a slice of the source buffer given to the Lexer,
+// which must outlive every token (and the parser using them).
 struct Token {
     TokenType type;
-    std::string value;
+    std::string_view value;
     int line;
     int col;
 };
 
+// Thrown once a syntax error the parsing can not recover from is reported
+struct SyntaxError {};
+
 std::string tokenToString(const TokenType &token);
 
 class Lexer {
-    std::string source;
+    std::string_view source;
     size_t current_pos = 0;
     int current_line = 1;
     int current_column = 1;
-
-    std::map<std::string, TokenType> keywords;
-    void initKeywords();
+    size_t tokenStart = 0;
+    bool finished = false;
+    bool speculative = false; // Stops at the first error instead of reporting it
+    bool failed = false;
 
     char peek(int offset = 0) const;
     char advance();
+    void advanceColumns(size_t length);
+    void advanceText(size_t length);
     void skipWhitespace();
-    Token createToken(TokenType type, const std::string& value = "", int startCol = -1) const;
+    void report(const std::string& message);
+    Token createToken(TokenType type, std::string_view value = "", int startCol = -1) const;
+    std::string_view slice(size_t start) const;
     Token matchKeywordOrIdentifier(int startCol);
     Token matchNumber(int startCol);
     Token matchString(int startCol);
 
 public:
-    explicit Lexer(std::string in);
+    explicit Lexer(std::string_view in);
+    /**
+     * @brief Lexer starting in the middle of 'in', used to lex chunks of a source in parallel
+     * @param offset Start of the lexing, 'line' and 'column' are its position in the source
+     * @param speculative If true, errors are not reported : the lexer stops and isFailed() becomes true
+     */
+    Lexer(std::string_view in, size_t offset, int line, int column, bool speculative);
+    // Lexes the whole source at once, the last token is T_EOF
     std::vector<Token> tokenize();
+    // Lexes the next token on demand, T_EOF once the end of the source is reached
+    Token next();
+    // True once the final T_EOF has been returned
+    [[nodiscard]] bool isFinished() const { return finished; }
+    [[nodiscard]] bool isFailed() const { return failed; }
+    // Offset in the source of the last token returned by next()
+    [[nodiscard]] size_t lastTokenOffset() const { return tokenStart; }
 };
 
 #endif //LEXER_H
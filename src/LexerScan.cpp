@@ -0,0 +1,300 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "LexerScan.h"
+
+#include <bit>
+#include <cstdint>
+
+// Helpers of the scanning loops : an unoptimized build would otherwise call them once per vector
+#if defined(__GNUC__) || defined(__clang__)
+    #define ONYX_ALWAYS_INLINE __attribute__((always_inline)) inline
+#elif defined(_MSC_VER)
+    #define ONYX_ALWAYS_INLINE __forceinline
+#else
+    #define ONYX_ALWAYS_INLINE inline
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define ONYX_SCAN_X86
+    #include <immintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define ONYX_TARGET_AVX2 __attribute__((target("avx2")))
+    #else
+        #include <intrin.h>
+        #define ONYX_TARGET_AVX2
+    #endif
+#endif
+
+// --- Scalar ---
+
+ONYX_ALWAYS_INLINE static bool isWhitespace(const char c) {
+    return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+ONYX_ALWAYS_INLINE static bool isDigit(const char c) {
+    return static_cast<unsigned char>(c - '0') <= 9;
+}
+
+ONYX_ALWAYS_INLINE static bool isIdentifier(const char c) {
+    return isDigit(c) || static_cast<unsigned char>((c | 0x20) - 'a') <= 'z' - 'a' || c == '_';
+}
+
+static WhitespaceSpan whitespaceScalar(const char* begin, const char* end) {
+    WhitespaceSpan span{0, 0, 0};
+    const char* p = begin;
+    while (p < end && isWhitespace(*p)) {
+        if (*p == '\n') {
+            span.newlines++;
+            span.lastNewline = p - begin;
+        }
+        p++;
+    }
+    span.length = p - begin;
+    return span;
+}
+
+static size_t identifierScalar(const char* begin, const char* end) {
+    const char* p = begin;
+    while (p < end && isIdentifier(*p)) p++;
+    return p - begin;
+}
+
+static size_t digitsScalar(const char* begin, const char* end) {
+    const char* p = begin;
+    while (p < end && isDigit(*p)) p++;
+    return p - begin;
+}
+
+// Scans a tail shorter than a vector, continuing a span started at 'begin'
+static void whitespaceTail(const char* begin, const char* p, const char* end, WhitespaceSpan& span) {
+    const WhitespaceSpan tail = whitespaceScalar(p, end);
+    if (tail.newlines) {
+        span.newlines += tail.newlines;
+        span.lastNewline = (p - begin) + tail.lastNewline;
+    }
+    span.length = (p - begin) + tail.length;
+}
+
+#ifdef ONYX_SCAN_X86
+
+// --- SSE2 (16 bytes per step) ---
+
+// Unsigned (c - low) <= range, per byte
+ONYX_ALWAYS_INLINE static __m128i inRange128(const __m128i c, const char low, const char range) {
+    const __m128i shifted = _mm_sub_epi8(c, _mm_set1_epi8(low));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(range)), shifted);
+}
+
+ONYX_ALWAYS_INLINE static __m128i whitespaceClass128(const __m128i c) {
+    return _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')), inRange128(c, '\t', '\r' - '\t'));
+}
+
+ONYX_ALWAYS_INLINE static __m128i identifierClass128(const __m128i c) {
+    const __m128i letters = inRange128(_mm_or_si128(c, _mm_set1_epi8(0x20)), 'a', 'z' - 'a');
+    const __m128i digits = inRange128(c, '0', 9);
+    return _mm_or_si128(_mm_or_si128(letters, digits), _mm_cmpeq_epi8(c, _mm_set1_epi8('_')));
+}
+
+static WhitespaceSpan whitespaceSSE2(const char* begin, const char* end) {
+    WhitespaceSpan span{0, 0, 0};
+    const char* p = begin;
+    for (; end - p >= 16; p += 16) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const uint32_t inClass = _mm_movemask_epi8(whitespaceClass128(c));
+        uint32_t newlines = _mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8('\n')));
+        const int stop = std::countr_one(inClass);
+        if (stop < 16) newlines &= (1u << stop) - 1;
+        if (newlines) {
+            span.newlines += std::popcount(newlines);
+            span.lastNewline = (p - begin) + 31 - std::countl_zero(newlines);
+        }
+        if (stop < 16) {
+            span.length = (p - begin) + stop;
+            return span;
+        }
+    }
+    whitespaceTail(begin, p, end, span);
+    return span;
+}
+
+static size_t identifierSSE2(const char* begin, const char* end) {
+    const char* p = begin;
+    for (; end - p >= 16; p += 16) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if (const int stop = std::countr_one(static_cast<uint32_t>(_mm_movemask_epi8(identifierClass128(c)))); stop < 16) {
+            return (p - begin) + stop;
+        }
+    }
+    return (p - begin) + identifierScalar(p, end);
+}
+
+static size_t digitsSSE2(const char* begin, const char* end) {
+    const char* p = begin;
+    for (; end - p >= 16; p += 16) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if (const int stop = std::countr_one(static_cast<uint32_t>(_mm_movemask_epi8(inRange128(c, '0', 9)))); stop < 16) {
+            return (p - begin) + stop;
+        }
+    }
+    return (p - begin) + digitsScalar(p, end);
+}
+
+// --- AVX2 (32 bytes per step) ---
+
+ONYX_TARGET_AVX2 ONYX_ALWAYS_INLINE static __m256i inRange256(const __m256i c, const char low, const char range) {
+    const __m256i shifted = _mm256_sub_epi8(c, _mm256_set1_epi8(low));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(range)), shifted);
+}
+
+ONYX_TARGET_AVX2 ONYX_ALWAYS_INLINE static uint32_t whitespaceMask256(const __m256i c) {
+    const __m256i inClass = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(' ')), inRange256(c, '\t', '\r' - '\t'));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(inClass));
+}
+
+ONYX_TARGET_AVX2 ONYX_ALWAYS_INLINE static uint32_t identifierMask256(const __m256i c) {
+    const __m256i letters = inRange256(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), 'a', 'z' - 'a');
+    const __m256i digits = inRange256(c, '0', 9);
+    const __m256i inClass = _mm256_or_si256(_mm256_or_si256(letters, digits), _mm256_cmpeq_epi8(c, _mm256_set1_epi8('_')));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(inClass));
+}
+
+// The AVX2 scanners clear the upper halves of the registers before returning : the compiler only does it
+// itself when optimizing, and the SSE code of the Lexer would otherwise pay a state transition after each call
+
+ONYX_TARGET_AVX2 static WhitespaceSpan whitespaceAVX2(const char* begin, const char* end) {
+    WhitespaceSpan span{0, 0, 0};
+    const char* p = begin;
+    for (; end - p >= 32; p += 32) {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const uint32_t inClass = whitespaceMask256(c);
+        uint32_t newlines = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('\n'))));
+        const int stop = std::countr_one(inClass);
+        if (stop < 32) newlines &= (1u << stop) - 1;
+        if (newlines) {
+            span.newlines += std::popcount(newlines);
+            span.lastNewline = (p - begin) + 31 - std::countl_zero(newlines);
+        }
+        if (stop < 32) {
+            span.length = (p - begin) + stop;
+            _mm256_zeroupper();
+            return span;
+        }
+    }
+    _mm256_zeroupper();
+    whitespaceTail(begin, p, end, span);
+    return span;
+}
+
+ONYX_TARGET_AVX2 static size_t identifierAVX2(const char* begin, const char* end) {
+    const char* p = begin;
+    for (; end - p >= 32; p += 32) {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        if (const int stop = std::countr_one(identifierMask256(c)); stop < 32) {
+            _mm256_zeroupper();
+            return (p - begin) + stop;
+        }
+    }
+    _mm256_zeroupper();
+    return (p - begin) + identifierScalar(p, end);
+}
+
+ONYX_TARGET_AVX2 static size_t digitsAVX2(const char* begin, const char* end) {
+    const char* p = begin;
+    for (; end - p >= 32; p += 32) {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        if (const int stop = std::countr_one(static_cast<uint32_t>(_mm256_movemask_epi8(inRange256(c, '0', 9)))); stop < 32) {
+            _mm256_zeroupper();
+            return (p - begin) + stop;
+        }
+    }
+    _mm256_zeroupper();
+    return (p - begin) + digitsScalar(p, end);
+}
+
+static bool cpuHasAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuidex(info, 1, 0);
+    const bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6; // OSXSAVE + XMM/YMM state
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#endif
+}
+
+#endif // ONYX_SCAN_X86
+
+// --- Dispatch ---
+
+struct Scanners {
+    ScanBackend backend;
+    WhitespaceSpan (*whitespace)(const char*, const char*);
+    size_t (*identifier)(const char*, const char*);
+    size_t (*digits)(const char*, const char*);
+};
+
+static Scanners scannersFor(const ScanBackend backend) {
+    switch (backend) {
+#ifdef ONYX_SCAN_X86
+        case ScanBackend::AVX2: return {backend, whitespaceAVX2, identifierAVX2, digitsAVX2};
+        case ScanBackend::SSE2: return {backend, whitespaceSSE2, identifierSSE2, digitsSSE2};
+#endif
+        default: return {ScanBackend::Scalar, whitespaceScalar, identifierScalar, digitsScalar};
+    }
+}
+
+static Scanners active = scannersFor(scan::defaultBackend());
+
+namespace scan {
+    WhitespaceSpan whitespace(const char* begin, const char* end) {
+        return active.whitespace(begin, end);
+    }
+
+    size_t identifier(const char* begin, const char* end) {
+        return active.identifier(begin, end);
+    }
+
+    size_t digits(const char* begin, const char* end) {
+        return active.digits(begin, end);
+    }
+
+    ScanBackend defaultBackend() {
+        return ScanBackend::Scalar;
+    }
+
+    bool supported(const ScanBackend backend) {
+        switch (backend) {
+#ifdef ONYX_SCAN_X86
+            case ScanBackend::AVX2: return cpuHasAVX2();
+            case ScanBackend::SSE2: return true;
+#endif
+            case ScanBackend::Scalar: return true;
+            default: return false;
+        }
+    }
+
+    ScanBackend activeBackend() {
+        return active.backend;
+    }
+
+    bool setBackend(const ScanBackend backend) {
+        if (!supported(backend)) {
+            return false;
+        }
+        active = scannersFor(backend);
+        return true;
+    }
+
+    const char* backendName(const ScanBackend backend) {
+        switch (backend) {
+            case ScanBackend::AVX2: return "AVX2";
+            case ScanBackend::SSE2: return "SSE2";
+            default: return "scalar";
+        }
+    }
+}
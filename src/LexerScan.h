@@ -0,0 +1,43 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef LEXERSCAN_H
+#define LEXERSCAN_H
+#include <cstddef>
+
+/**
+ * Bulk character classification used by the Lexer hot loops.
+ * Each scanner returns the length of the longest prefix of [begin, end) made of its character class.
+ *
+ * The vectorized versions (SSE2, AVX2) classify 16 or 32 bytes at once. Most tokens are only a
+ * few characters long : on the lexer benchmark neither beats the scalar version in an optimized
+ * build, and both are several times slower in an unoptimized one. The scalar version is the
+ * default, the others are only used when selected with setBackend.
+ */
+
+enum class ScanBackend { Scalar, SSE2, AVX2 };
+
+struct WhitespaceSpan {
+    size_t length;
+    size_t newlines;    // Number of '\n' in the span
+    size_t lastNewline; // Offset of the last '\n' in the span, only meaningful if newlines > 0
+};
+
+namespace scan {
+    // ' ', '\t', '\n', '\v', '\f', '\r'
+    WhitespaceSpan whitespace(const char* begin, const char* end);
+    // [A-Za-z0-9_]
+    size_t identifier(const char* begin, const char* end);
+    // [0-9]
+    size_t digits(const char* begin, const char* end);
+
+    ScanBackend defaultBackend();
+    bool supported(ScanBackend backend);
+    ScanBackend activeBackend();
+    // Forces a backend (benchmarks), returns false if the CPU does not support it
+    bool setBackend(ScanBackend backend);
+    const char* backendName(ScanBackend backend);
+}
+
+#endif //LEXERSCAN_H
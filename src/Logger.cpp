@@ -5,13 +5,38 @@
 #include "Logger.h"
 
 #include <iostream>
+#include <sstream>
 
 void Logger::Log(const std::string &str) {
     std::cout << "Log : " << str << std::endl;
 }
 
+static thread_local std::vector<Logger::Message>* sink = nullptr;
+
+void Logger::Write(const std::string& text, const bool error) {
+    if (sink) {
+        sink->push_back({text, error});
+        return;
+    }
+    (error ? std::cerr : std::cout) << text << std::flush;
+}
+
 void Logger::Error(const std::string &str) {
-    std::cerr << "Error : " << str << std::endl;
+    Write("Error : " + str + '\n');
+}
+
+Logger::Capture::Capture(std::vector<Message>& newSink) : previous(sink) {
+    sink = &newSink;
+}
+
+Logger::Capture::~Capture() {
+    sink = previous;
+}
+
+void Logger::Flush(const std::vector<Message>& messages) {
+    for (const auto& [text, error] : messages) {
+        Write(text, error);
+    }
 }
 
 void Logger::Report(const Token &token, const std::string &message) {
@@ -20,14 +45,16 @@ void Logger::Report(const Token &token, const std::string &message) {
     const std::string ANSI_RESET = "\033[0m";
     const std::string ANSI_BLUE = "\033[34m";
 
+    std::ostringstream out;
     const int numSize = static_cast<int>(std::to_string(token.line).length());
-    std::cerr << "" << "todo:filename" << "@" << token.line << ":" << token.col << "" << std::endl;
-    std::cerr << std::string(numSize, ' ') << " |" << std::endl;
+    out << "" << "todo:filename" << "@" << token.line << ":" << token.col << "" << std::endl;
+    out << std::string(numSize, ' ') << " |" << std::endl;
 
-    std::cerr << token.line << " | " << "todo:print the actual line" << std::endl;
-    std::cerr << std::string(numSize, ' ') << " | " << std::string(token.col - 1, ' ') << "" << "^";
+    out << token.line << " | " << "todo:print the actual line" << std::endl;
+    out << std::string(numSize, ' ') << " | " << std::string(token.col - 1, ' ') << "" << "^";
     if (token.value.length() > 1) {
-        std::cerr << std::string(token.value.length() - 1, '~');
+        out << std::string(token.value.length() - 1, '~');
     }
-    std::cerr << " " << message << "" << std::endl;
+    out << " " << message << "" << std::endl;
+    Write(out.str());
 }
@@ -5,6 +5,7 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 #include <string>
+#include <vector>
 
 #include "Lexer.h"
 
@@ -12,9 +13,31 @@
 class Logger {
 
 public:
+    // Output kept aside by a Capture
+    struct Message {
+        std::string text;
+        bool error = true; // Error stream, standard output otherwise
+        bool operator==(const Message&) const = default;
+    };
+
     static void Log(const std::string &str);
     static void Error(const std::string &str);
     static void Report(const Token& token, const std::string& message);
+    // Raw diagnostic text, captured like the errors
+    static void Write(const std::string& text, bool error = true);
+
+    // While it lives, the diagnostics of the current thread are stored in 'sink' instead of being printed
+    class Capture {
+        std::vector<Message>* previous;
+    public:
+        explicit Capture(std::vector<Message>& sink);
+        ~Capture();
+        Capture(const Capture&) = delete;
+        Capture& operator=(const Capture&) = delete;
+    };
+
+    // Outputs captured messages, in order
+    static void Flush(const std::vector<Message>& messages);
 };
 
 
@@ -0,0 +1,66 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ModuleGraph.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "Logger.h"
+
+void ModuleGraph::addModule(const string& name, const vector<string>& imports) {
+    this->imports[name] = imports;
+    declared[name] = imports;
+}
+
+void ModuleGraph::sort(const string& root) {
+    sorted.clear();
+    ranks.clear();
+    enum class State { Unvisited, Visiting, Done };
+    map<string, State> states;
+    vector<string> path; // Modules being visited, from the root
+
+    function<void(const string&)> visit = [&](const string& module) {
+        states[module] = State::Visiting;
+        path.push_back(module);
+        auto& edges = imports[module];
+        erase_if(edges, [&](const string& imported) {
+            const State state = states[imported];
+            if (state == State::Visiting) {
+                string cycle;
+                for (auto it = find(path.begin(), path.end(), imported); it != path.end(); ++it) {
+                    cycle += *it + " -> ";
+                }
+                Logger::Error("Import cycle : " + cycle + imported + ".");
+                return true;
+            }
+            if (state == State::Unvisited) {
+                visit(imported);
+            }
+            return false;
+        });
+        path.pop_back();
+        states[module] = State::Done;
+        ranks.emplace(module, sorted.size());
+        sorted.push_back(module);
+    };
+    visit(root);
+}
+
+const vector<string>& ModuleGraph::dependencies(const string& module) const {
+    static const vector<string> none;
+    const auto it = imports.find(module);
+    return it == imports.end() ? none : it->second;
+}
+
+const vector<string>& ModuleGraph::declaredImports(const string& module) const {
+    static const vector<string> none;
+    const auto it = declared.find(module);
+    return it == declared.end() ? none : it->second;
+}
+
+size_t ModuleGraph::rank(const string& module) const {
+    const auto it = ranks.find(module);
+    return it == ranks.end() ? sorted.size() : it->second;
+}
@@ -0,0 +1,46 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef MODULEGRAPH_H
+#define MODULEGRAPH_H
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Imports between the modules of a compilation, as a directed acyclic graph
+ *
+ * Modules are added with the modules they import, then sort walks the imports depth-first
+ * from the main module : every import closing a cycle is reported and left out of the graph,
+ * so the dependencies of a module always come before it in order().
+ */
+class ModuleGraph {
+public:
+    void addModule(const string& name, const vector<string>& imports);
+
+    // Orders the modules reachable from 'root', reports and drops the imports closing a cycle
+    void sort(const string& root);
+
+    // Modules imported by 'module' (none for a module the graph does not know)
+    [[nodiscard]] const vector<string>& dependencies(const string& module) const;
+
+    // Modules imported by 'module' as written, imports closing a cycle included
+    [[nodiscard]] const vector<string>& declaredImports(const string& module) const;
+
+    // Every module after its dependencies, in the order of a depth-first walk from the root
+    [[nodiscard]] const vector<string>& order() const { return sorted; }
+
+    // Position of 'module' in order(), modules the graph does not know come after the others
+    [[nodiscard]] size_t rank(const string& module) const;
+
+private:
+    map<string, vector<string>> imports;
+    map<string, vector<string>> declared;
+    vector<string> sorted;
+    map<string, size_t> ranks;
+};
+
+#endif //MODULEGRAPH_H
@@ -0,0 +1,123 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ModuleIndex.h"
+
+#include <fstream>
+
+// First line of the cache file, to be changed along with its format
+static constexpr string_view CacheHeader = "onyx-module-index 1";
+
+static int64_t modificationTime(const filesystem::path& directory) {
+    error_code error;
+    const auto time = filesystem::last_write_time(directory, error);
+    return error ? -1 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+ModuleIndex::ModuleIndex(const vector<string>& searchPaths, const filesystem::path& cacheFile) : searchPaths(searchPaths) {
+    if (load(cacheFile)) {
+        fromCache = true;
+        return;
+    }
+    // Whatever an invalid cache file filled in is discarded
+    directories.clear();
+    modules.clear();
+    walk(cacheFile.parent_path());
+    save(cacheFile);
+}
+
+optional<filesystem::path> ModuleIndex::find(const string& module) const {
+    if (const auto it = modules.find(module); it != modules.end()) {
+        return it->second;
+    }
+    return nullopt;
+}
+
+void ModuleIndex::walk(const filesystem::path& cacheDirectory) {
+    for (const auto& root : searchPaths) {
+        error_code error, ignored;
+        if (!filesystem::is_directory(root, ignored)) continue;
+        directories.push_back({root, modificationTime(root)});
+
+        filesystem::recursive_directory_iterator it(root, filesystem::directory_options::skip_permission_denied, error);
+        for (; !error && it != filesystem::recursive_directory_iterator(); it.increment(error)) {
+            const auto& entry = *it;
+            if (entry.is_directory(ignored)) {
+                const string name = entry.path().filename().string();
+                if (name.starts_with('.') || filesystem::equivalent(entry.path(), cacheDirectory, ignored)) {
+                    it.disable_recursion_pending();
+                    continue;
+                }
+                directories.push_back({entry.path().string(), modificationTime(entry.path())});
+            } else if (entry.path().extension() == ".ox" && entry.is_regular_file(ignored)) {
+                // The first search path holding the module wins
+                modules.emplace(entry.path().stem().string(), entry.path());
+            }
+        }
+    }
+}
+
+// Cache file : the header, then one line per search path, directory and module,
+// each made of a tag and its fields, the path last as it may contain spaces
+bool ModuleIndex::load(const filesystem::path& cacheFile) {
+    ifstream stream(cacheFile);
+    string line;
+    if (!getline(stream, line) || line != CacheHeader) {
+        return false;
+    }
+
+    size_t searchPath = 0;
+    while (getline(stream, line)) {
+        const size_t tagEnd = line.find(' ');
+        if (tagEnd == string::npos) return false;
+        const string_view tag = string_view(line).substr(0, tagEnd);
+        const string fields = line.substr(tagEnd + 1);
+        if (tag == "search") {
+            if (searchPath == searchPaths.size() || fields != searchPaths[searchPath++]) return false;
+            continue;
+        }
+        const size_t fieldEnd = fields.find(' ');
+        if (fieldEnd == string::npos) return false;
+        const string first = fields.substr(0, fieldEnd);
+        const string path = fields.substr(fieldEnd + 1);
+        if (tag == "dir") {
+            int64_t modified;
+            try {
+                modified = stoll(first);
+            } catch (const exception&) {
+                return false;
+            }
+            // Something was added, removed or renamed in this directory since the index was saved
+            if (modificationTime(path) != modified) return false;
+            directories.push_back({path, modified});
+        } else if (tag == "module") {
+            modules.emplace(first, path);
+        } else {
+            return false;
+        }
+    }
+    return searchPath == searchPaths.size();
+}
+
+void ModuleIndex::save(const filesystem::path& cacheFile) const {
+    error_code error;
+    filesystem::create_directories(cacheFile.parent_path(), error);
+    // Written aside then renamed, a concurrent compile never reads half an index
+    const filesystem::path temporary = cacheFile.string() + ".tmp";
+    {
+        ofstream stream(temporary);
+        if (!stream.is_open()) return;
+        stream << CacheHeader << '\n';
+        for (const auto& path : searchPaths) {
+            stream << "search " << path << '\n';
+        }
+        for (const auto& [path, modified] : directories) {
+            stream << "dir " << modified << ' ' << path << '\n';
+        }
+        for (const auto& [name, path] : modules) {
+            stream << "module " << name << ' ' << path.string() << '\n';
+        }
+    }
+    filesystem::rename(temporary, cacheFile, error);
+}
@@ -0,0 +1,56 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef MODULEINDEX_H
+#define MODULEINDEX_H
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Where each module of a compilation lives, to resolve the extern statements
+ *
+ * Built once per compile by walking the search paths : the first path holding a 'name.ox'
+ * provides module 'name'. The walk skips the hidden directories and the directory of the
+ * cache file (generated code only).
+ *
+ * The index is saved in its cache file along with the modification time of every directory
+ * walked. Adding, removing or renaming a file changes the time of its directory, so as long
+ * as every recorded time is unchanged, the next compile loads the index instead of walking.
+ */
+class ModuleIndex {
+public:
+    // Loads the cached index if it is still valid, walks the search paths and saves it otherwise
+    ModuleIndex(const vector<string>& searchPaths, const filesystem::path& cacheFile);
+    ModuleIndex() = default;
+
+    // Path of the source file of 'module' (name without the .ox extension)
+    [[nodiscard]] optional<filesystem::path> find(const string& module) const;
+
+    [[nodiscard]] size_t size() const { return modules.size(); }
+    // True if the index was loaded from the cache file, without walking the search paths
+    [[nodiscard]] bool cached() const { return fromCache; }
+
+private:
+    struct Directory {
+        string path;
+        int64_t modified;
+    };
+
+    vector<string> searchPaths;
+    vector<Directory> directories;   // Every directory walked, to check the cache
+    unordered_map<string, filesystem::path> modules;
+    bool fromCache = false;
+
+    void walk(const filesystem::path& cacheDirectory);
+    [[nodiscard]] bool load(const filesystem::path& cacheFile);
+    void save(const filesystem::path& cacheFile) const;
+};
+
+#endif //MODULEINDEX_H
@@ -0,0 +1,98 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ModuleInterface.h"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "ASTSerializer.h"
+#include "SourceFile.h"
+
+static constexpr string_view InterfaceHeader = "onyx-interface 1";
+
+string ModuleInterface::sourceStamp(const filesystem::path& source) {
+    error_code error;
+    const auto size = filesystem::file_size(source, error);
+    if (error) return "";
+    const auto time = filesystem::last_write_time(source, error);
+    if (error) return "";
+    return to_string(size) + ' ' + to_string(time.time_since_epoch().count());
+}
+
+template <typename Node>
+static vector<unique_ptr<Node>> cloneAll(const vector<unique_ptr<Node>>& nodes) {
+    vector<unique_ptr<Node>> copies;
+    copies.reserve(nodes.size());
+    for (const auto& node : nodes) {
+        copies.push_back(cloneAs(*node));
+    }
+    return copies;
+}
+
+// Signature of 'node' with an empty body, the node itself when it has no body
+static unique_ptr<AST> declarationOf(const AST& node) {
+    if (const auto function = ast_cast<FunctionDefinitionAST>(&node)) {
+        return make_unique<FunctionDefinitionAST>(cloneAs(*function->returnType), function->name, cloneAll(function->params),
+                                                  make_unique<BlockAST>(), function->isStatic);
+    }
+    if (const auto constructor = ast_cast<ConstructorDefinitionAST>(&node)) {
+        return make_unique<ConstructorDefinitionAST>(constructor->structName, cloneAll(constructor->params), make_unique<BlockAST>());
+    }
+    if (const auto declaration = ast_cast<VariableDeclarationAST>(&node)) {
+        return make_unique<VariableDeclarationAST>(cloneAs(*declaration->type), declaration->name, nullptr);
+    }
+    if (const auto extends = ast_cast<ExtendsStatementAST>(&node)) {
+        vector<unique_ptr<AST>> members;
+        for (const auto& member : extends->members) {
+            members.push_back(declarationOf(*member));
+        }
+        return make_unique<ExtendsStatementAST>(extends->structName, extends->parentStructName, move(members));
+    }
+    return node.clone();
+}
+
+unique_ptr<BlockAST> ModuleInterface::declarationsOf(const BlockAST& module) {
+    auto declarations = make_unique<BlockAST>();
+    for (const auto& statement : module.statements) {
+        declarations->statements.push_back(declarationOf(*statement));
+    }
+    return declarations;
+}
+
+optional<ModuleInterface> ModuleInterface::load(const filesystem::path& file, const filesystem::path& source) {
+    const SourceFile saved(file.string());
+    if (!saved.isOpen()) return nullopt;
+    const string_view content = saved.view();
+    const size_t headerEnd = content.find('\n');
+    const size_t stampEnd = headerEnd == string_view::npos ? headerEnd : content.find('\n', headerEnd + 1);
+    if (stampEnd == string_view::npos || content.substr(0, headerEnd) != InterfaceHeader) return nullopt;
+
+    // Stamp line : size and modification time of the source, then its hash
+    const string_view stamp = content.substr(headerEnd + 1, stampEnd - headerEnd - 1);
+    const size_t hashStart = stamp.rfind(' ');
+    const string current = sourceStamp(source);
+    if (hashStart == string_view::npos || current.empty() || stamp.substr(0, hashStart) != current) return nullopt;
+
+    ModuleInterface loaded{string(stamp.substr(hashStart + 1)), deserializeAST(content.substr(stampEnd + 1))};
+    if (!loaded.declarations) return nullopt;
+    return loaded;
+}
+
+void ModuleInterface::save(const filesystem::path& file, const string& stamp, const string& sourceHash, const BlockAST& declarations) {
+    if (stamp.empty()) return;
+    error_code error;
+    filesystem::create_directories(file.parent_path(), error);
+    // Written aside then renamed : a module being loaded never sees a partial interface
+    ostringstream temporary;
+    temporary << file.string() << '.' << this_thread::get_id() << ".tmp";
+    {
+        ofstream stream(temporary.str(), ios::binary);
+        if (!stream.is_open()) return;
+        stream << InterfaceHeader << '\n' << stamp << ' ' << sourceHash << '\n' << serializeAST(declarations);
+        if (!stream) return;
+    }
+    filesystem::rename(temporary.str(), file, error);
+}
@@ -0,0 +1,44 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef MODULEINTERFACE_H
+#define MODULEINTERFACE_H
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "AST.h"
+
+using namespace std;
+
+/**
+ * @brief What the modules importing a module can see of it, saved by each compile
+ *
+ * The interface is the module without its bodies : imports, structures with their fields and
+ * generic parameters, function, method and constructor signatures, top-level variables and extern
+ * blocks. prePass and declare fill a SymbolTable from it as they would from the whole module,
+ * so an unchanged dependency is neither read nor parsed again.
+ * It is stored as a serialized AST (see ASTSerializer.h) after the size and modification time of
+ * its source, which tell whether the source changed without reading it.
+ */
+class ModuleInterface {
+public:
+    string sourceHash; // Hash of the source the interface was made from (see BuildState)
+    unique_ptr<BlockAST> declarations;
+
+    // Declarations of 'module', every body left empty
+    static unique_ptr<BlockAST> declarationsOf(const BlockAST& module);
+
+    // Interface in 'file' if 'source' did not change since it was saved. Nodes go to the current ASTArena
+    static optional<ModuleInterface> load(const filesystem::path& file, const filesystem::path& source);
+    // 'declarations' come from declarationsOf. 'stamp' is the sourceStamp taken before the source was read,
+    // so an edit made during the compile is never missed
+    static void save(const filesystem::path& file, const string& stamp, const string& sourceHash, const BlockAST& declarations);
+
+    // Size and modification time of 'source', "" if it can not be read
+    static string sourceStamp(const filesystem::path& source);
+};
+
+#endif //MODULEINTERFACE_H
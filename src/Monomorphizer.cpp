@@ -3,61 +3,86 @@
 //
 
 #include "Monomorphizer.h"
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "Logger.h"
 
-string ensureTypeIsInstantiated(TypeAST* type, SymbolTable& table) {
+TypeId ensureTypeIsInstantiated(TypeAST* type, SymbolTable& table) {
+    const TypeId concreteType = type->id();
     if (type->genericArgs.empty()) {
-        return type->type; // Simple type
+        return concreteType; // Simple type
     }
+    table.noteInstantiation(*type);
 
-    const string mangledName = type->getMangledName();
-    if (auto concreteName = table.findInstantiation(mangledName)) {
-        return *concreteName; // Type already instantiated
-    }
-
-    // --- INSTANTIATION ---
     const auto* templateAST = table.lookupTemplate(type->type); // Get the AST associated to the template
     if (!templateAST) {
         Logger::Error("Generic type '" + type->type + "' not found.");
-        return "error_type";
+        return TypeTable::Error;
+    }
+    if (table.lookupInstantiation(templateAST, *type)) {
+        return concreteType; // Type already instantiated
+    }
+    if (type->genericArgs.size() != templateAST->genericParams.size()) {
+        Logger::Error("Generic type '" + type->type + "' expects " + to_string(templateAST->genericParams.size())
+                      + " arguments, found " + to_string(type->genericArgs.size()) + " in '" + type->source() + "'.");
+        return TypeTable::Error;
+    }
+    // --- INSTANTIATION ---
+
+    // A body analysed concurrently leaves the instantiation to the thread owning the global table
+    if (table.requestInstantiation(*type)) {
+        return concreteType;
     }
 
     // 1. AST cloning
     auto clonedASTNode = templateAST->clone();
-    auto* clonedStruct = dynamic_cast<StructDefinitionAST*>(clonedASTNode.get());
+    auto* clonedStruct = static_cast<StructDefinitionAST*>(clonedASTNode.get());
 
     // 2. Creating map that associate generic parameter with a concrete type
     map<string, unique_ptr<TypeAST>> typeMap;
     for (size_t i = 0; i < templateAST->genericParams.size(); ++i) {
-        auto clonedArg = type->genericArgs[i]->clone();
-        typeMap[templateAST->genericParams[i]->name] = unique_ptr<TypeAST>(dynamic_cast<TypeAST*>(clonedArg.release()));
+        typeMap[templateAST->genericParams[i]->name] = cloneAs(*type->genericArgs[i]);
     }
 
     // 3. Substitute types in the AST
     substitute_recursive(clonedStruct, typeMap);
 
-    // 4. Generate an identifier for the type
-    string concreteName = type->type;
-    for(const auto& arg : type->genericArgs) {
-        concreteName += "_" + arg->type;
-    }
-    clonedStruct->name = concreteName;
+    // 4. The instantiated type is named after the mangled name of the type
+    clonedStruct->name = concreteType.name();
+    clonedStruct->instanceOf = concreteType;
 
-    // 5. Analyse the generated type
+    // 5. Registered before its analysis : a field of the same type refers to it instead of instantiating it again
+    table.addInstantiation(templateAST, *type, clonedStruct);
+
+    // 6. Analyse the generated type. Its declarations are visible to every body, whichever statement
+    // instantiated it first (see SymbolTable::position)
+    const uint32_t position = exchange(table.position, 0);
     clonedStruct->prePass(table);
     clonedStruct->analyse(table);
+    table.position = position;
 
-    // 6. Register the generated type
+    // 7. Register the generated type
     table.registerGeneric(move(clonedASTNode));
     //globalBlock.statements.push_back(move(clonedASTNode));
-    table.addInstantiation(mangledName);
 
-    return concreteName;
+    return concreteType;
 }
 
 
+void InstantiationQueue::push(const size_t task, TypeAST* type) {
+    std::lock_guard lock(mutex);
+    requests.push_back({task, type});
+}
+
+vector<InstantiationQueue::Request> InstantiationQueue::drain() {
+    std::lock_guard lock(mutex);
+    // A task runs on a single thread, its requests are already in order
+    ranges::stable_sort(requests, {}, &Request::task);
+    return exchange(requests, {});
+}
+
 void substitute_type(unique_ptr<TypeAST>& type, const map<string, unique_ptr<TypeAST>>& typeMap);
 
 void substitute_recursive(AST* node, const map<string, unique_ptr<TypeAST>>& typeMap) {
@@ -65,110 +90,103 @@ void substitute_recursive(AST* node, const map<string, unique_ptr<TypeAST>>& typ
         return;
     }
 
-    // --- Structures & Functions ---
+    switch (node->kind) {
+        // --- Structures & Functions ---
 
-    if (auto* structDef = dynamic_cast<StructDefinitionAST*>(node)) {
-        // Clear all generics parameters
-        structDef->genericParams.clear();
-        for (auto& field : structDef->fields) {
-            substitute_recursive(field.get(), typeMap);
+        case ASTKind::StructDefinition: {
+            auto* structDef = static_cast<StructDefinitionAST*>(node);
+            // Clear all generics parameters
+            structDef->genericParams.clear();
+            for (auto& field : structDef->fields) {
+                substitute_recursive(field.get(), typeMap);
+            }
+            return;
         }
-        return;
-    }
-    if (auto* field = dynamic_cast<StructFieldAST*>(node)) {
-        substitute_type(field->type, typeMap);
-        return;
-    }
-    if (auto* funcDef = dynamic_cast<FunctionDefinitionAST*>(node)) {
-        substitute_type(funcDef->returnType, typeMap);
-        for (auto& param : funcDef->params) {
-            substitute_recursive(param.get(), typeMap);
+        case ASTKind::StructField:
+            substitute_type(static_cast<StructFieldAST*>(node)->type, typeMap);
+            return;
+        case ASTKind::FunctionDefinition: {
+            auto* funcDef = static_cast<FunctionDefinitionAST*>(node);
+            substitute_type(funcDef->returnType, typeMap);
+            for (auto& param : funcDef->params) {
+                substitute_recursive(param.get(), typeMap);
+            }
+            substitute_recursive(funcDef->body.get(), typeMap);
+            return;
         }
-        substitute_recursive(funcDef->body.get(), typeMap);
-        return;
-    }
-    if (const auto* ctorDef = dynamic_cast<ConstructorDefinitionAST*>(node)) {
-        for (auto& param : ctorDef->params) {
-            substitute_recursive(param.get(), typeMap);
+        case ASTKind::ConstructorDefinition: {
+            const auto* ctorDef = static_cast<ConstructorDefinitionAST*>(node);
+            for (auto& param : ctorDef->params) {
+                substitute_recursive(param.get(), typeMap);
+            }
+            substitute_recursive(ctorDef->body.get(), typeMap);
+            return;
         }
-        substitute_recursive(ctorDef->body.get(), typeMap);
-        return;
-    }
-
-    if (auto* param = dynamic_cast<FunctionParameterAST*>(node)) {
-        substitute_type(param->type, typeMap);
-        return;
-    }
-
-    if (const auto* extendsStmt = dynamic_cast<ExtendsStatementAST*>(node)) {
-        for (auto& member : extendsStmt->members) {
-            substitute_recursive(member.get(), typeMap);
+        case ASTKind::FunctionParameter:
+            substitute_type(static_cast<FunctionParameterAST*>(node)->type, typeMap);
+            return;
+        case ASTKind::ExtendsStatement:
+            for (auto& member : static_cast<ExtendsStatementAST*>(node)->members) {
+                substitute_recursive(member.get(), typeMap);
+            }
+            return;
+
+        // --- Statements ---
+
+        case ASTKind::Block:
+            for (auto& stmt : static_cast<BlockAST*>(node)->statements) {
+                substitute_recursive(stmt.get(), typeMap);
+            }
+            return;
+        case ASTKind::VariableDeclaration: {
+            auto* varDecl = static_cast<VariableDeclarationAST*>(node);
+            substitute_type(varDecl->type, typeMap);
+            if (varDecl->initializer) {
+                substitute_recursive(varDecl->initializer.get(), typeMap);
+            }
+            return;
         }
-        return;
-    }
-
-    // --- Statements ---
-
-    if (const auto* block = dynamic_cast<BlockAST*>(node)) {
-        for (auto& stmt : block->statements) {
-            substitute_recursive(stmt.get(), typeMap);
+        case ASTKind::VariableAssignment: {
+            const auto* varAssign = static_cast<VariableAssignmentAST*>(node);
+            substitute_recursive(varAssign->target.get(), typeMap);
+            substitute_recursive(varAssign->value.get(), typeMap);
+            return;
         }
-        return;
-    }
-
-    if (auto* varDecl = dynamic_cast<VariableDeclarationAST*>(node)) {
-        substitute_type(varDecl->type, typeMap);
-        if (varDecl->initializer) {
-            substitute_recursive(varDecl->initializer.get(), typeMap);
+        case ASTKind::Return:
+            substitute_recursive(static_cast<ReturnAST*>(node)->value.get(), typeMap);
+            return;
+        case ASTKind::IfStatement: {
+            const auto* ifStmt = static_cast<IfStatementAST*>(node);
+            substitute_recursive(ifStmt->condition.get(), typeMap);
+            substitute_recursive(ifStmt->thenBody.get(), typeMap);
+            if (ifStmt->elseBody) {
+                substitute_recursive(ifStmt->elseBody.get(), typeMap);
+            }
+            return;
         }
-        return;
-    }
 
-    if (const auto* varAssign = dynamic_cast<VariableAssignmentAST*>(node)) {
-        substitute_recursive(varAssign->target.get(), typeMap);
-        substitute_recursive(varAssign->value.get(), typeMap);
-        return;
-    }
+        // --- Expressions ---
 
-    if (const auto* ret = dynamic_cast<ReturnAST*>(node)) {
-        substitute_recursive(ret->value.get(), typeMap);
-        return;
-    }
-
-    if (const auto* ifStmt = dynamic_cast<IfStatementAST*>(node)) {
-        substitute_recursive(ifStmt->condition.get(), typeMap);
-        substitute_recursive(ifStmt->thenBody.get(), typeMap);
-        if (ifStmt->elseBody) {
-            substitute_recursive(ifStmt->elseBody.get(), typeMap);
+        case ASTKind::OperationExpr: {
+            const auto* op = static_cast<OperationExprAST*>(node);
+            substitute_recursive(op->LHS.get(), typeMap);
+            substitute_recursive(op->RHS.get(), typeMap);
+            return;
         }
-        return;
-    }
-
-    // --- Expressions ---
-
-    if (const auto* op = dynamic_cast<OperationExprAST*>(node)) {
-        substitute_recursive(op->LHS.get(), typeMap);
-        substitute_recursive(op->RHS.get(), typeMap);
-        return;
-    }
-
-    if (const auto* call = dynamic_cast<FunctionCallAST*>(node)) {
-        for (auto& arg : call->params) {
-            substitute_recursive(arg.get(), typeMap);
-        }
-        return;
-    }
-
-    if (const auto* methodCall = dynamic_cast<MethodCallAST*>(node)) {
-        substitute_recursive(methodCall->ownerExpr.get(), typeMap);
-        for (auto& arg : methodCall->params) {
-            substitute_recursive(arg.get(), typeMap);
-        }
-        return;
-    }
-
-    if (const auto* fieldAccess = dynamic_cast<FieldAccessAST*>(node)) {
-        substitute_recursive(fieldAccess->ownerExpr.get(), typeMap);
+        case ASTKind::MethodCall:
+            substitute_recursive(static_cast<MethodCallAST*>(node)->ownerExpr.get(), typeMap);
+            [[fallthrough]];
+        case ASTKind::FunctionCall:
+            for (auto& arg : static_cast<FunctionCallAST*>(node)->params) {
+                substitute_recursive(arg.get(), typeMap);
+            }
+            return;
+        case ASTKind::FieldAccess:
+            substitute_recursive(static_cast<FieldAccessAST*>(node)->ownerExpr.get(), typeMap);
+            return;
+
+        default:
+            return; // Leaves without types
     }
 }
 
@@ -177,7 +195,7 @@ void substitute_type(unique_ptr<TypeAST>& type, const map<string, unique_ptr<Typ
 
     // Current type is a generic
     if (typeMap.contains(type->type)) {
-        type = unique_ptr<TypeAST>(dynamic_cast<TypeAST*>(typeMap.at(type->type)->clone().release()));
+        type = cloneAs(*typeMap.at(type->type));
         return;
     }
 
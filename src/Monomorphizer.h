@@ -8,6 +8,8 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include "AST.h"
 
 using namespace std;
@@ -26,8 +28,30 @@ void substitute_recursive(AST* node, const map<string, unique_ptr<TypeAST>>& typ
  * @brief Check if a type is instantiated, if not, create an instance according to the template
  * @param type The type to check
  * @param table
- * @return The type signature after instantiation
+ * @return The concrete type, named after its mangled name once instantiated
  */
-string ensureTypeIsInstantiated(TypeAST* type, SymbolTable& table);
+TypeId ensureTypeIsInstantiated(TypeAST* type, SymbolTable& table);
+
+/**
+ * @brief Instantiations requested by function bodies analysed concurrently (see analyseParallel)
+ *
+ * The bodies only read the global table : the requests are performed afterwards, by one thread.
+ */
+class InstantiationQueue {
+public:
+    struct Request {
+        size_t task;    // Body that made the request
+        TypeAST* type;
+    };
+
+    void push(size_t task, TypeAST* type);
+
+    // Pending requests, sorted by task then in the order each task made them
+    vector<Request> drain();
+
+private:
+    std::mutex mutex;
+    vector<Request> requests;
+};
 
 #endif //MONOMORPHIZER_H
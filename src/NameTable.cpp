@@ -0,0 +1,52 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "NameTable.h"
+
+#include <mutex>
+
+const std::string& NameId::str() const {
+    return NameTable::Global().str(*this);
+}
+
+NameTable& NameTable::Global() {
+    static NameTable table;
+    return table;
+}
+
+NameTable::NameTable() {
+    intern("");
+}
+
+NameId NameTable::intern(const std::string_view name) {
+    if (const auto id = find(name)) {
+        return *id;
+    }
+    std::unique_lock lock(mutex);
+    if (const auto it = ids.find(name); it != ids.end()) {
+        return it->second; // Interned by another thread in the meantime
+    }
+    const NameId id(static_cast<uint32_t>(names.size()));
+    names.emplace_back(name);
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+std::optional<NameId> NameTable::find(const std::string_view name) const {
+    std::shared_lock lock(mutex);
+    if (const auto it = ids.find(name); it != ids.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+const std::string& NameTable::str(const NameId id) const {
+    std::shared_lock lock(mutex);
+    return names[id.index()];
+}
+
+size_t NameTable::size() const {
+    std::shared_lock lock(mutex);
+    return names.size();
+}
@@ -0,0 +1,69 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef NAMETABLE_H
+#define NAMETABLE_H
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Identifier of an interned name (variable, function signature, structure, field...)
+ *
+ * Ids are dense : they can index a vector directly.
+ */
+class NameId {
+    uint32_t value = 0;
+public:
+    constexpr NameId() = default;
+    constexpr explicit NameId(const uint32_t value) : value(value) {}
+
+    [[nodiscard]] constexpr uint32_t index() const { return value; }
+    constexpr bool operator==(const NameId&) const = default;
+
+    [[nodiscard]] const std::string& str() const;
+};
+
+template <>
+struct std::hash<NameId> {
+    size_t operator()(const NameId id) const noexcept { return id.index(); }
+};
+
+/**
+ * @brief Global interner of the identifiers used by the SymbolTable
+ *
+ * Safe to use from several threads, only interning a new name takes an exclusive lock.
+ */
+class NameTable {
+public:
+    static constexpr NameId Empty {0};
+
+    static NameTable& Global();
+
+    NameId intern(std::string_view name);
+    // Id of an already interned name, nullopt if the name was never interned
+    [[nodiscard]] std::optional<NameId> find(std::string_view name) const;
+
+    [[nodiscard]] const std::string& str(NameId id) const;
+    [[nodiscard]] size_t size() const;
+
+private:
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(const std::string_view key) const noexcept { return std::hash<std::string_view>{}(key); }
+    };
+
+    std::deque<std::string> names; // Stable addresses : names are handed out by reference
+    std::unordered_map<std::string, NameId, KeyHash, std::equal_to<>> ids;
+    mutable std::shared_mutex mutex;
+
+    NameTable();
+};
+
+#endif //NAMETABLE_H
@@ -0,0 +1,92 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ObjectCache.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+#include "ContentHash.h"
+
+static string readFile(const filesystem::path& path) {
+    ifstream stream(path, ios::binary);
+    ostringstream content;
+    content << stream.rdbuf();
+    return content.str();
+}
+
+// Adds 'file' and the headers it includes with quotes, when they exist next to it
+static void hashWithIncludes(const filesystem::path& file, ContentHash& hash, unordered_set<string>& seen) {
+    if (!seen.insert(file.lexically_normal().string()).second) return;
+    const string content = readFile(file);
+    hash.add(file.filename().string());
+    hash.add(content);
+
+    istringstream lines(content);
+    string line;
+    while (getline(lines, line)) {
+        const size_t directive = line.find_first_not_of(" \t");
+        if (directive == string::npos || line.compare(directive, 8, "#include") != 0) continue;
+        const size_t open = line.find('"', directive + 8);
+        const size_t close = open == string::npos ? string::npos : line.find('"', open + 1);
+        if (close == string::npos) continue;
+        const filesystem::path header = file.parent_path() / line.substr(open + 1, close - open - 1);
+        if (filesystem::is_regular_file(header)) {
+            hashWithIncludes(header, hash, seen);
+        }
+    }
+}
+
+ObjectCache::ObjectCache(const filesystem::path& directory, const string& compiler, const string& flags)
+    : directory(directory), compiler(compiler), flags(flags) {
+    error_code error;
+    filesystem::create_directories(directory, error);
+    const filesystem::path versionFile = directory / "compiler-version.txt";
+    const string command = compiler + " --version > " + versionFile.string() + " 2>&1";
+    version = system(command.c_str()) == 0 ? readFile(versionFile) : string();
+}
+
+string ObjectCache::key(const filesystem::path& source, const vector<filesystem::path>& headers) const {
+    ContentHash hash;
+    hash.add(compiler);
+    hash.add(version);
+    hash.add(flags);
+    unordered_set<string> seen;
+    hashWithIncludes(source, hash, seen);
+    for (const auto& header : headers) {
+        if (filesystem::is_regular_file(header)) {
+            hashWithIncludes(header, hash, seen);
+        }
+    }
+    return hash.str();
+}
+
+ObjectCache::Result ObjectCache::compile(const filesystem::path& source, const vector<filesystem::path>& headers) {
+    const auto start = chrono::steady_clock::now();
+    const auto elapsed = [&] { return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count(); };
+
+    const filesystem::path object = directory / (key(source, headers) + ".o");
+    if (filesystem::exists(object)) {
+        hitCount++;
+        return {true, true, elapsed(), object};
+    }
+    missCount++;
+    // Compiled aside then renamed : the store never holds a partial object, even when
+    // several compilers produce the same one at once
+    ostringstream temporary;
+    temporary << object.string() << '.' << this_thread::get_id() << ".tmp";
+    const string command = compiler + (flags.empty() ? "" : " " + flags) + " -c " + source.string() + " -o " + temporary.str();
+    bool success = system(command.c_str()) == 0;
+    error_code error;
+    if (success) {
+        filesystem::rename(temporary.str(), object, error);
+        success = !error;
+    } else {
+        filesystem::remove(temporary.str(), error);
+    }
+    return {success, false, elapsed(), object};
+}
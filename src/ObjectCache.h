@@ -0,0 +1,52 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef OBJECTCACHE_H
+#define OBJECTCACHE_H
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Content-addressed store of the objects compiled from the generated C
+ *
+ * An object is stored under a hash of everything that can change it : the C file, the local
+ * headers it includes (recursively), the version of the C compiler and the flags.
+ * Compiling a file whose hash is already in the store gives back the stored object without
+ * running the compiler. Objects are never evicted, the directory can be deleted at any time.
+ */
+class ObjectCache {
+public:
+    struct Result {
+        bool success;
+        bool cached;          // The object came from the store
+        double milliseconds;  // Wall time, hashing included
+        filesystem::path object;
+    };
+
+    // 'compiler' is run once with --version, its output is part of every key
+    ObjectCache(const filesystem::path& directory, const string& compiler, const string& flags);
+
+    // Object of 'source' (a .c file), compiled only if it is not in the store yet. Thread-safe.
+    // 'headers' are part of the key as if 'source' included them, whether it names them or not
+    Result compile(const filesystem::path& source, const vector<filesystem::path>& headers = {});
+
+    [[nodiscard]] size_t hits() const { return hitCount; }
+    [[nodiscard]] size_t misses() const { return missCount; }
+
+private:
+    filesystem::path directory;
+    string compiler;
+    string flags;
+    string version;
+    atomic<size_t> hitCount = 0;
+    atomic<size_t> missCount = 0;
+
+    [[nodiscard]] string key(const filesystem::path& source, const vector<filesystem::path>& headers) const;
+};
+
+#endif //OBJECTCACHE_H
@@ -4,92 +4,248 @@
 
 #include "Onyx.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <ranges>
+#include <set>
 #include <sstream>
+#include <thread>
 #include <variant>
 
+#include "ASTSerializer.h"
+#include "CodeEmitter.h"
 #include "CodeGenerator.h"
 #include "Logger.h"
+#include "ModuleInterface.h"
+#include "Monomorphizer.h"
+#include "ObjectCache.h"
+#include "ParallelAnalysis.h"
+#include "ParallelLexer.h"
 #include "Parser.h"
+#include "PassManager.h"
+#include "SourceFile.h"
 #include "SymbolTable.h"
 
-// returns true if the given name is a valid module name (without .ox extension)
-bool checkLib(const string& name) {
-    for (const auto& entry : filesystem::recursive_directory_iterator("./")) {
-        if (entry.is_regular_file() && entry.path().filename() == name + ".ox") {
-            return true;
+ThreadPool& Onyx::Pool() {
+    if (!pool) {
+        pool = make_unique<ThreadPool>(jobs);
+    }
+    return *pool;
+}
+
+ASTArena& Onyx::Arena(const string& module) {
+    lock_guard lock(arenasMutex);
+    return arenas.try_emplace(module).first->second;
+}
+
+bool Onyx::Visit(const string& module) {
+    lock_guard lock(visitedMutex);
+    return visited.insert(module).second;
+}
+
+// Writes a generated file at once, the content is built in memory beforehand.
+// A file with the same content is left untouched, so its timestamp stays stable
+static void writeFile(const string& path, const string_view content) {
+    error_code error;
+    if (filesystem::file_size(path, error) == content.size() && !error) {
+        ifstream existing(path, ios::binary);
+        string current(content.size(), '\0');
+        if (existing.read(current.data(), static_cast<streamsize>(current.size())) && current == content) {
+            return;
+        }
+    }
+    ofstream stream(path, ios::binary);
+    if (stream.is_open()) {
+        stream.write(content.data(), static_cast<streamsize>(content.size()));
+    }
+}
+
+string moduleName(const string& path) {
+    return filesystem::path(path).stem().string();
+}
+
+// Index of the modules found in the search paths, kept between compiles
+static const string ModuleIndexFile = "build/modules.index";
+// Hashes of the modules compiled last time (see BuildState)
+static const string BuildStateFile = "build/incremental.state";
+// Serialized ASTs and compiled objects, both keyed by a content hash
+static const string CacheDirectory = "build/.cache";
+
+static filesystem::path cachedASTPath(const string& sourceHash) {
+    return filesystem::path(CacheDirectory) / (sourceHash + ".ast");
+}
+
+// Declarations of each module, saved after it is analysed without errors (see ModuleInterface)
+static filesystem::path interfacePath(const string& module) {
+    return "build/" + module + ".interface";
+}
+
+// Modules 'module' imports directly or through other modules, cycles included
+static set<string> reachableImports(const string& module, const ModuleGraph& graph) {
+    set<string> reached;
+    vector<string> pending = {module};
+    while (!pending.empty()) {
+        const string next = move(pending.back());
+        pending.pop_back();
+        for (const auto& imported : graph.declaredImports(next)) {
+            if (reached.insert(imported).second) {
+                pending.push_back(imported);
+            }
+        }
+    }
+    return reached;
+}
+
+// Modules whose source and the interfaces of every module they can reach did not change since the
+// 'previous' compile. The symbol table is global : a module also binds to what its imports import
+static set<string> upToDateModules(const BuildState& previous, const BuildState& current, const ModuleGraph& graph) {
+    const auto interfaceChanged = [&](const string& module) {
+        const auto before = previous.modules.find(module);
+        const auto now = current.modules.find(module);
+        return before == previous.modules.end() || now == current.modules.end()
+            || before->second.interfaceHash != now->second.interfaceHash;
+    };
+    set<string> upToDate;
+    for (const auto& [module, record] : current.modules) {
+        const auto before = previous.modules.find(module);
+        if (before == previous.modules.end() || before->second.hadErrors || record.hadErrors
+            || before->second.sourceHash != record.sourceHash) continue;
+        // Its generated files may have been deleted since
+        if (!filesystem::exists("build/" + module + ".c") || !filesystem::exists("build/" + module + ".h")) continue;
+        if (ranges::none_of(reachableImports(module, graph), interfaceChanged)) {
+            upToDate.insert(module);
         }
     }
-    return false;
+    return upToDate;
 }
 
 optional<string> Onyx::Compile(const string &sourcefile) {
     auto map = BuildASTMap(sourcefile);
-    // Prepass all the modules found
-    SymbolTable table;
-    for (auto &ast: map | views::values) {
-        ast->prePass(table);
+    if (!success) {
+        exit(EXIT_FAILURE);
     }
-    // Analyse all the modules
-    for (auto &ast: map | views::values) {
-        ast->analyse(table);
+    const string mainModule = moduleName(sourcefile);
+    state.mainModule = mainModule;
+    for (const auto& [module, ast] : map) {
+        state.modules[module].interfaceHash = BuildState::interfaceHash(*ast);
+    }
+    BuildState previous;
+    set<string> upToDate;
+    if (incremental && previous.load(BuildStateFile) && previous.mainModule == mainModule) {
+        upToDate = upToDateModules(previous, state, graph);
+    }
+    // An interface is enough for a module kept as it is, the others are analysed from their source
+    for (auto& [module, source] : sources) {
+        if (!source.interfaceOnly || upToDate.contains(module)) continue;
+        ParsedModule parsed = ParseModule(source.path, false);
+        Logger::Flush(parsed.messages);
+        if (parsed.failed) {
+            exit(EXIT_FAILURE);
+        }
+        state.modules[module].hadErrors = ranges::any_of(parsed.messages, &Logger::Message::error);
+        map[module] = move(parsed.ast);
+        source = parsed.source;
+    }
+    // Taken before the analysis, which adds to the ASTs
+    std::map<string, unique_ptr<BlockAST>> interfaces;
+    for (const auto& [module, source] : sources) {
+        if (!source.interfaceOnly) {
+            interfaces[module] = ModuleInterface::declarationsOf(*map[module]);
+        }
     }
 
-    map["generics"] = move(table.generics);
-
-    bool flag = false;
-    // Code generation of used modules
-    for (auto& [module, ast] : map) {
-        ast->analyse(table);
-
+    // Nodes created by the analysis (generic instantiations) go to their own arena
+    ASTArena::Scope genericsArena(Arena("generics"));
+    SymbolTable table;
+    SymbolTable::InstantiationLog usedInstantiations;
+    table.usedInstantiations = &usedInstantiations;
+    PassManager passes(map, graph, &Pool());
+    // Hoists the top-level declarations of every module
+    passes.addPass("prePass", {}, {"prePass"}, [&](const string&, unique_ptr<BlockAST>& ast) {
+        ast->prePass(table);
+    });
+    passes.addPass("analyse", {"prePass"}, {"analyse"}, [&](const string& module, unique_ptr<BlockAST>& ast) {
+        auto& record = state.modules[module];
+        if (upToDate.contains(module)) {
+            // Its generated code is kept : only what the other modules use is registered again
+            ast->declare(table);
+            record.instantiations = previous.modules[module].instantiations;
+            for (const auto& typeSource : record.instantiations) {
+                Lexer lexer(typeSource);
+                Parser parser(lexer);
+                if (const auto type = parser.parseType()) {
+                    ensureTypeIsInstantiated(type.get(), table);
+                }
+            }
+            return;
+        }
+        usedInstantiations.clear();
+        vector<Logger::Message> messages;
+        {
+            Logger::Capture capture(messages);
+            if (parallelAnalysis) {
+                analyseParallel(*ast, table, Pool());
+            } else {
+                ast->analyse(table);
+            }
+        }
+        Logger::Flush(messages);
+        record.hadErrors |= ranges::any_of(messages, &Logger::Message::error);
+        record.instantiations.assign(usedInstantiations.types.begin(), usedInstantiations.types.end());
+    });
+    // Code generation of used modules, only reads the analysed AST of its module : it runs on the pool while
+    // the modules importing it are analysed
+    passes.addPass("codegen", {"analyse"}, {}, [&](const string& module, unique_ptr<BlockAST>& ast) {
         // Generate the #includes
         string imports;
         for (auto& imported : ast->statements) {
-            if (auto importStmt = dynamic_cast<ExternStatementAST*>(imported.get())) {
+            if (auto importStmt = ast_cast<ExternStatementAST>(imported.get())) {
                 imports += "#include \"" + importStmt->libraryName + ".h\"\n";
             }
         }
 
-        CodeGenerator generator(move(ast));
+        // The AST stays in the map : modules analysed later may still refer to its declarations
+        CodeGenerator generator(*ast);
 
         // Generate code in './build/module.h'
         if (!filesystem::is_directory("build") || !filesystem::exists("build")) {
             filesystem::create_directory("build");
         }
-        ofstream stream("build/" + module + ".h");
-        if (stream.is_open()) {
-            stream << "// Generated by Onyx compiler." << endl;
-            stream << "#ifndef " << module << "_H" << endl << "#define " << module << "_H" << endl;
+        CodeEmitter header;
+        header << "// Generated by Onyx compiler.\n";
+        header << "#ifndef " << module << "_H\n" << "#define " << module << "_H\n";
 
-            // TODO : import builtins
-            stream << "#include \"builtins.h\"" << endl << endl;
+        // TODO : import builtins
+        header << "#include \"builtins.h\"\n\n";
 
-            stream << generator.generateHeader() << endl;
-
-            stream << "#endif" << endl;
-        }
+        generator.generateHeader(header);
+        header << "\n#endif\n";
+        writeFile("build/" + module + ".h", header.str());
 
         // Generate code in './build/module.c'
-        stream = ofstream("build/" + module + ".c");
-        if (stream.is_open()) {
-            stream << "// Generated by Onyx compiler." << endl;
-            stream << "#include \"" + module +".h\"" << endl;
-            stream << imports;
-
-            if (!flag) {
-                flag = true;
-                // Pool defined in the first module found, but initialised in the main function
-                stream << "PtrIntList* global_pool;" << endl;
-            }
+        CodeEmitter source;
+        source << "// Generated by Onyx compiler.\n";
+        source << "#include \"" << module << ".h\"\n";
+        source << imports;
 
-            stream << generator.generate() << endl;
+        if (module == mainModule) {
+            // Pool defined in the main module, and initialised in the main function
+            source << "PtrIntList* global_pool;\n";
         }
-        stream.close();
+
+        generator.generate(source);
+        source << '\n';
+        writeFile("build/" + module + ".c", source.str());
+    }, PassManager::Execution::Concurrent);
+
+    for (const auto& module : upToDate) {
+        passes.markDone(module, "codegen");
     }
 
-    // Compilation
+    // Compilation : one object per module, once every module and the instantiations are generated
     string executable;
 #ifdef OS_WINDOWS
     executable = "a.exe";
@@ -97,16 +253,54 @@ optional<string> Onyx::Compile(const string &sourcefile) {
     executable = "a.out";
 #endif
 
-    string buildFiles = "./build/memory.c";
-    for (const auto &module: map | views::keys) {
-        buildFiles += " ./build/" + module + ".c";
-    }
+    // Objects of the C files generated identically by a previous compile are reused
+    ObjectCache objectCache("./" + CacheDirectory, "clang", "");
+    mutex compiledMutex;
+    std::map<string, ObjectCache::Result> compiled;
+    // Needs the C of its module and the headers of its imports, not their objects.
+    // Every module header includes builtins.h, which includes the generated generics.h
+    passes.addPass("compile", {"codegen"}, {"codegen"}, [&](const string& module, unique_ptr<BlockAST>&) {
+        const auto result = objectCache.compile("./build/" + module + ".c", {"./build/generics.h"});
+        lock_guard lock(compiledMutex);
+        compiled.emplace(module, result);
+    }, PassManager::Execution::Concurrent);
 
-    string buildFile = "./build/" + filesystem::path(sourcefile).stem().string() + ".c";
-    string command = "clang " + buildFiles + " -o " + executable;
     std::cout << "Compiling program..." << endl;
-    int result = system(command.c_str());
-    if (result != 0) {
+    // The runtime is not a module, it is compiled alongside them
+    auto runtime = Pool().submit([&] { return objectCache.compile("./build/memory.c"); });
+    // Analysis runs here in import order, generation of the analysed modules on the pool meanwhile
+    passes.run("codegen");
+
+    // Instantiations are pre-passed and analysed when they are created (see ensureTypeIsInstantiated),
+    // they are complete once every module is analysed
+    map["generics"] = move(table.generics);
+    passes.markDone("generics", "prePass");
+    passes.markDone("generics", "analyse");
+    passes.run("codegen");
+    // Not before : a module compiled against a missing or previous generics.h would be wrong, and cached so
+    passes.run("compile");
+    compiled.emplace("memory", runtime.get());
+    // Generated files and state match from here, whatever the C compiler made of them
+    for (const auto& [module, declarations] : interfaces) {
+        if (!state.modules[module].hadErrors) {
+            ModuleInterface::save(interfacePath(module), sources[module].stamp, state.modules[module].sourceHash, *declarations);
+        }
+    }
+    state.save(BuildStateFile);
+    if (timePasses) {
+        passes.printTimings(cout);
+    }
+
+    bool compiledAll = true;
+    string objects;
+    for (const auto& [module, result] : compiled) {
+        std::cout << "  " << left << setw(16) << module << right << fixed << setprecision(1) << setw(9)
+                  << result.milliseconds << " ms" << (!result.success ? "  (failed)" : result.cached ? "  (cached)" : "") << endl;
+        compiledAll &= result.success;
+        objects += " " + result.object.string();
+    }
+    std::cout << "Object cache : " << objectCache.hits() << " hits, " << objectCache.misses() << " misses." << endl;
+    if (!compiledAll || system(("clang" + objects + " -o " + executable).c_str()) != 0) {
         std::cerr << "Error while compiling intermediate representation." << endl;
         return nullopt;
     }
@@ -114,65 +308,182 @@ optional<string> Onyx::Compile(const string &sourcefile) {
     return "./" + executable;
 }
 
-// TODO : check if file found or not
 unique_ptr<BlockAST> Onyx::BuildAST(const string& sourcefile) {
-    std::ifstream file (sourcefile);
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string content = buffer.str();
+    ASTArena::Scope arena(Arena(filesystem::path(sourcefile).stem().string()));
+    const SourceFile source(sourcefile);
+    if (!source.isOpen()) {
+        Logger::Error("Could not open source file '" + sourcefile + "'.");
+        return make_unique<BlockAST>();
+    }
 
-    Lexer lexer (content);
-    Parser parser(lexer.tokenize());
+    // Tokens are views into the mapping : 'source' must stay alive until parsing is done.
+    // A module parsed on a worker already runs alongside the others, it is lexed sequentially
+    if (source.view().size() >= ParallelLexThreshold && std::thread::hardware_concurrency() > 1 && !ThreadPool::isWorkerThread()) {
+        Parser parser(tokenizeParallel(source.view(), Pool()));
+        return parser.parse();
+    }
+    Lexer lexer (source.view());
+    Parser parser(lexer); // Tokens are streamed, the module is never fully tokenized in memory
     auto ast = parser.parse();
     return ast;
 }
 
-string moduleName(const string& path) {
-    return filesystem::path(path).stem().string();
+unique_ptr<BlockAST> Onyx::LoadCachedAST(const string& module, const string& sourceHash) {
+    const SourceFile cached(cachedASTPath(sourceHash).string());
+    if (!cached.isOpen()) {
+        return nullptr;
+    }
+    ASTArena::Scope arena(Arena(module));
+    return deserializeAST(cached.view());
+}
+
+// Written aside then renamed : a concurrent load never sees a partial file
+static void saveCachedAST(const BlockAST& ast, const string& sourceHash) {
+    error_code error;
+    filesystem::create_directories(CacheDirectory, error);
+    const filesystem::path file = cachedASTPath(sourceHash);
+    ostringstream temporary;
+    temporary << file.string() << '.' << this_thread::get_id() << ".tmp";
+    const string bytes = serializeAST(ast);
+    {
+        ofstream stream(temporary.str(), ios::binary);
+        if (!stream.write(bytes.data(), static_cast<streamsize>(bytes.size()))) return;
+    }
+    filesystem::rename(temporary.str(), file, error);
 }
-bool contains(const std::vector<string>& vec, const string& element) {
-    for (const auto & i : vec) {
-        if (i == element) {
-            return true;
+
+// Modules imported by the top-level extern statements of 'ast', in order
+static vector<string> importsOf(const BlockAST& ast) {
+    vector<string> imports;
+    for (auto& stmt : ast.statements) {
+        if (const auto ext = ast_cast<ExternStatementAST>(stmt.get())) {
+            imports.push_back(ext->libraryName);
         }
     }
-    return false;
+    return imports;
+}
+
+Onyx::ParsedModule Onyx::ParseModule(const string& sourcefile, const bool useInterface) {
+    ParsedModule module{moduleName(sourcefile), {sourcefile, ModuleInterface::sourceStamp(sourcefile)}};
+    Logger::Capture capture(module.messages);
+    if (useInterface) {
+        ASTArena::Scope arena(Arena(module.name));
+        auto saved = ModuleInterface::load(interfacePath(module.name), sourcefile);
+        // A module whose imports moved away is parsed again, to report them where they are written
+        if (saved && ranges::all_of(importsOf(*saved->declarations), [&](const string& imported) { return moduleIndex.find(imported).has_value(); })) {
+            module.source.interfaceOnly = true;
+            module.sourceHash = move(saved->sourceHash);
+            module.ast = move(saved->declarations);
+            module.imports = importsOf(*module.ast);
+            return module;
+        }
+    }
+
+    module.sourceHash = BuildState::sourceHash(sourcefile);
+    // Only modules parsed without any diagnostic are cached, loading one reports nothing
+    module.ast = LoadCachedAST(module.name, module.sourceHash);
+    if (!module.ast) {
+        // Parsing may run on a worker : a syntax error is only reported, the main thread prints it and stops
+        try {
+            module.ast = BuildAST(sourcefile);
+        } catch (const SyntaxError&) {
+            module.failed = true;
+            module.ast = make_unique<BlockAST>();
+            return module;
+        }
+        if (module.messages.empty()) {
+            saveCachedAST(*module.ast, module.sourceHash);
+        }
+    }
+    for (const auto& imported : importsOf(*module.ast)) {
+        if (moduleIndex.find(imported)) {
+            module.imports.push_back(imported);
+            continue;
+        }
+        Logger::Error("Module '" + imported + "' not found.");
+    }
+    return module;
 }
 
 map<string, unique_ptr<BlockAST>> Onyx::BuildASTMap(const string &sourcefile) {
     map<string, unique_ptr<BlockAST>> result;
-    if (contains(visited, moduleName(sourcefile))) {
+    if (!Visit(moduleName(sourcefile))) {
         return result;
     }
-    auto main = BuildAST(sourcefile);
-    vector<string> imports;
-    // Look for all top-level extern statements
-    for (auto& stmt : main->statements) {
-        if (const auto ext = dynamic_cast<ExternStatementAST*>(stmt.get())) {
-            if (checkLib(ext->libraryName)) {
-                imports.emplace_back(ext->libraryName);
+    // Read only from here on, the parsing tasks share it
+    moduleIndex = ModuleIndex(searchPaths, ModuleIndexFile);
+
+    // Every module is parsed on the pool as soon as an import of it is seen.
+    // A task submits the imports it claims before it completes, so once the futures
+    // before 'next' are all done, 'pending' holds every module left to wait for
+    mutex pendingMutex;
+    vector<future<ParsedModule>> pending;
+    function<void(const ParsedModule&)> submitImports = [&](const ParsedModule& parsed) {
+        for (const auto& mod : parsed.imports) {
+            // Skip if the module has already been claimed
+            if (!Visit(mod)) {
                 continue;
             }
-            Logger::Error("Module '" + ext->libraryName + "' not found.");
+            const string path = moduleIndex.find(mod)->string();
+            lock_guard lock(pendingMutex);
+            pending.push_back(Pool().submit([this, path, &submitImports] {
+                ParsedModule imported = ParseModule(path, incremental);
+                submitImports(imported);
+                return imported;
+            }));
         }
-    }
-    for (const auto& mod : imports) {
-        // Skip if the module has already been visited
-        if (contains(visited, mod)) {
-            continue;
+    };
+
+    // The main module may be lexed in parallel, it is parsed on this thread
+    Pool();
+    vector<ParsedModule> modules;
+    modules.push_back(ParseModule(sourcefile, incremental));
+    submitImports(modules.front());
+    for (size_t next = 0;; next++) {
+        future<ParsedModule> task;
+        {
+            lock_guard lock(pendingMutex);
+            if (next == pending.size()) break;
+            task = move(pending[next]);
         }
-        // Build the module
-        for (const auto& entry : filesystem::recursive_directory_iterator("./")) {
-            if (entry.is_regular_file() && entry.path().filename() == mod + ".ox") {
-                for (auto& [key, val] : BuildASTMap(entry.path().filename().string())) {
-                    result.emplace(key, move(val));
-                }
-                visited.emplace_back(mod);
-                break;
+        modules.push_back(task.get());
+    }
+
+    // Diagnostics in the order of a depth-first walk of the imports, whatever the parsing order
+    std::map<string, ParsedModule*> byName;
+    for (auto& module : modules) {
+        byName.emplace(module.name, &module);
+    }
+    unordered_set<string> reported;
+    function<void(ParsedModule&)> report = [&](ParsedModule& module) {
+        if (!reported.insert(module.name).second) return;
+        Logger::Flush(module.messages);
+        for (const auto& mod : module.imports) {
+            if (const auto it = byName.find(mod); it != byName.end()) {
+                report(*it->second);
             }
         }
+    };
+    report(modules.front());
+    if (ranges::any_of(modules, &ParsedModule::failed)) {
+        success = false;
+        return result;
+    }
+
+    graph = ModuleGraph();
+    state = BuildState();
+    sources.clear();
+    for (const auto& module : modules) {
+        graph.addModule(module.name, module.imports);
+        sources[module.name] = module.source;
+        auto& record = state.modules[module.name];
+        record.sourceHash = module.sourceHash;
+        record.hadErrors = ranges::any_of(module.messages, &Logger::Message::error);
+    }
+    graph.sort(modules.front().name);
+
+    for (auto& module : modules) {
+        result.emplace(module.name, move(module.ast));
     }
-    visited.emplace_back(moduleName(sourcefile));
-    result.emplace(moduleName(sourcefile), move(main));
     return result;
 }
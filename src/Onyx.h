@@ -5,9 +5,17 @@
 #ifndef ONYX_H
 #define ONYX_H
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 
 #include "AST.h"
+#include "ASTArena.h"
+#include "BuildState.h"
+#include "Logger.h"
+#include "ModuleGraph.h"
+#include "ModuleIndex.h"
+#include "ThreadPool.h"
 
 #if defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
     #define OS_WINDOWS
@@ -18,9 +26,53 @@
 #endif
 
 class Onyx {
-    bool success = true;
+    bool success = true; // Cleared when a module could not be parsed
+    // One arena per module owning its AST nodes, plus "generics" for the instantiated templates.
+    // Declared first : the arenas must outlive every AST built by this compiler
+    map<string, ASTArena> arenas;
+    mutex arenasMutex;
+    unique_ptr<ThreadPool> pool; // Created on first use
+    ModuleIndex moduleIndex; // Built at the start of BuildASTMap
+    ModuleGraph graph; // Imports between the modules returned by BuildASTMap
+    BuildState state;  // Modules of this compile, their source hashes are set by BuildASTMap
+    unordered_set<string> visited; // Modules already claimed by the front end
+    mutex visitedMutex;
+
+    // Where a module returned by BuildASTMap was read from
+    struct ModuleSource {
+        string path;
+        string stamp;               // ModuleInterface::sourceStamp, taken before reading the source
+        bool interfaceOnly = false; // Only its declarations were loaded, from its interface
+    };
+    std::map<string, ModuleSource> sources;
+
+    // Parsed module, with what its parsing reported and the modules it imports
+    struct ParsedModule {
+        string name;
+        ModuleSource source;
+        string sourceHash;
+        unique_ptr<BlockAST> ast;
+        vector<Logger::Message> messages;
+        vector<string> imports;
+        bool failed = false; // Its parsing stopped at a syntax error, 'ast' is empty
+    };
+    // The interface of an unchanged module is loaded instead of its source when 'useInterface' is set
+    ParsedModule ParseModule(const string& sourcefile, bool useInterface);
+    // AST of the module whose source hashes to 'sourceHash' if a previous parse serialized it, null otherwise
+    unique_ptr<BlockAST> LoadCachedAST(const string& module, const string& sourceHash);
 public:
-    vector<string> visited;
+    // Modules at least this large are lexed on several threads
+    static constexpr size_t ParallelLexThreshold = 4 << 20;
+    bool timePasses = false; // Prints the time spent in each pass after the compilation
+    bool parallelAnalysis = false; // Analyses the function bodies of a module concurrently
+    bool incremental = true; // Skips the analysis and code generation of the modules unchanged since the previous compile
+    size_t jobs = 0; // Tasks run at once (C compilations included), one per hardware thread when 0
+    vector<string> searchPaths = {"./"}; // Directories searched for the imported modules, in order
+
+    ThreadPool& Pool();
+    ASTArena& Arena(const string& module);
+    // Claims 'module' for parsing, false if it was already claimed
+    bool Visit(const string& module);
     optional<string> Compile(const string &sourcefile);
     unique_ptr<BlockAST> BuildAST(const string& sourcefile);
     map<string, unique_ptr<BlockAST>> BuildASTMap(const string& sourcefile);
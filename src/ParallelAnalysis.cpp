@@ -0,0 +1,69 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ParallelAnalysis.h"
+
+#include <vector>
+
+#include "Logger.h"
+#include "Monomorphizer.h"
+
+void analyseParallel(BlockAST& module, SymbolTable& table, ThreadPool& pool) {
+    vector<vector<Logger::Message>> errors(module.statements.size()); // Per statement
+    vector<size_t> bodies;
+    vector<uint32_t> positions(module.statements.size()); // Per statement, what a body there may see
+
+    table.enterScope();
+    for (size_t i = 0; i < module.statements.size(); i++) {
+        AST* stmt = module.statements[i].get();
+        if (isa<FunctionDefinitionAST>(stmt) || isa<ConstructorDefinitionAST>(stmt)) {
+            bodies.push_back(i);
+            positions[i] = table.position;
+            continue;
+        }
+        Logger::Capture capture(errors[i]);
+        table.position++;
+        stmt->analyse(table);
+    }
+
+    while (!bodies.empty()) {
+        InstantiationQueue queue;
+        vector<vector<Logger::Message>> bodyErrors(bodies.size());
+        pool.parallelFor(bodies.size(), [&](const size_t task) {
+            // One local table per thread, reused by the bodies it analyses
+            thread_local unique_ptr<SymbolTable> scopes;
+            const uint32_t position = positions[bodies[task]];
+            if (scopes) {
+                scopes->reset(table, queue, task, position);
+            } else {
+                scopes = make_unique<SymbolTable>(table, queue, task, position);
+            }
+            Logger::Capture capture(bodyErrors[task]);
+            module.statements[bodies[task]]->analyse(*scopes);
+        });
+
+        // The errors of a body requesting an instantiation are dropped : it is analysed again once it exists
+        vector<bool> retry(bodies.size(), false);
+        for (const auto& [task, type] : queue.drain()) {
+            Logger::Capture capture(errors[bodies[task]]);
+            ensureTypeIsInstantiated(type, table);
+            retry[task] = true;
+        }
+        vector<size_t> next;
+        for (size_t task = 0; task < bodies.size(); task++) {
+            if (retry[task]) {
+                next.push_back(bodies[task]);
+                continue;
+            }
+            auto& statementErrors = errors[bodies[task]];
+            statementErrors.insert(statementErrors.end(), bodyErrors[task].begin(), bodyErrors[task].end());
+        }
+        bodies = move(next);
+    }
+    table.exitScope();
+
+    for (const auto& statementErrors : errors) {
+        Logger::Flush(statementErrors);
+    }
+}
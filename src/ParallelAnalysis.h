@@ -0,0 +1,23 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef PARALLELANALYSIS_H
+#define PARALLELANALYSIS_H
+
+#include "AST.h"
+#include "SymbolTable.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Analyses a module like BlockAST::analyse, with the function and constructor bodies analysed on 'pool'
+ *
+ * The other top-level statements are analysed first, in order, on the calling thread. The bodies then
+ * run concurrently, each in a local SymbolTable over the global one at the position of the body : the
+ * declarations of the statements that follow it are hidden, as they are when analysing in source order.
+ * Generic instantiations requested by the bodies are queued and performed afterwards, then the bodies
+ * that requested one are analysed again. Errors are reported in statement order, whatever the scheduling.
+ */
+void analyseParallel(BlockAST& module, SymbolTable& table, ThreadPool& pool);
+
+#endif //PARALLELANALYSIS_H
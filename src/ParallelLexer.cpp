@@ -0,0 +1,105 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ParallelLexer.h"
+
+#include <algorithm>
+
+namespace {
+    struct Chunk {
+        size_t begin;
+        size_t end;
+        std::vector<Token> tokens;   // Tokens starting in [begin, end), lines relative to the chunk
+        std::vector<size_t> offsets; // Source offset of each token
+        size_t next = 0;             // Offset of the first token starting at or after 'end'
+        size_t newlines = 0;         // Newlines in [begin, end)
+        bool failed = false;
+    };
+
+    // Lexes tokens starting before 'end', returns the offset of the first token starting after
+    size_t lexRange(Lexer& lexer, const size_t end, const size_t sourceSize, std::vector<Token>& tokens, std::vector<size_t>* offsets) {
+        while (true) {
+            const Token token = lexer.next();
+            if (lexer.isFinished()) {
+                return sourceSize; // Reached the end of the source (the final T_EOF is added by the caller)
+            }
+            const size_t offset = lexer.lastTokenOffset();
+            if (offset >= end) {
+                return offset;
+            }
+            tokens.push_back(token);
+            if (offsets) offsets->push_back(offset);
+        }
+    }
+
+    void lexChunk(const std::string_view source, Chunk& chunk) {
+        Lexer lexer(source, chunk.begin, 1, 1, true);
+        chunk.next = lexRange(lexer, chunk.end, source.size(), chunk.tokens, &chunk.offsets);
+        chunk.failed = lexer.isFailed();
+        chunk.newlines = std::count(source.begin() + chunk.begin, source.begin() + chunk.end, '\n');
+    }
+}
+
+std::vector<Token> tokenizeParallel(const std::string_view source, ThreadPool& pool, size_t minChunkSize) {
+    minChunkSize = std::max<size_t>(minChunkSize, 1);
+    const size_t chunkCount = std::min(source.size() / minChunkSize, pool.size() * 4);
+    if (chunkCount < 2) {
+        return Lexer(source).tokenize();
+    }
+
+    // Split at line boundaries
+    std::vector<Chunk> chunks;
+    size_t begin = 0;
+    for (size_t i = 1; i <= chunkCount && begin < source.size(); i++) {
+        size_t end = source.size();
+        if (i < chunkCount) {
+            const size_t newline = source.find('\n', std::max(begin, i * source.size() / chunkCount));
+            end = newline == std::string_view::npos ? source.size() : newline + 1;
+        }
+        chunks.push_back({begin, end});
+        begin = end;
+    }
+
+    std::vector<std::future<void>> pending;
+    pending.reserve(chunks.size());
+    for (auto& chunk : chunks) {
+        pending.push_back(pool.submit([source, &chunk] { lexChunk(source, chunk); }));
+    }
+    for (auto& task : pending) {
+        task.get();
+    }
+
+    // Stitch the chunks, 'expected' is where the sequential lexer would start its next token
+    std::vector<Token> out;
+    size_t expected = 0;
+    int firstLine = 1; // Line of the current chunk start
+    for (const auto& chunk : chunks) {
+        if (expected < chunk.end) {
+            const auto it = std::lower_bound(chunk.offsets.begin(), chunk.offsets.end(), expected);
+            if (!chunk.failed && it != chunk.offsets.end() && *it == expected) {
+                // The speculative lexing agrees with the sequential one from this token on
+                for (auto token = chunk.tokens.begin() + (it - chunk.offsets.begin()); token != chunk.tokens.end(); ++token) {
+                    out.push_back(*token);
+                    out.back().line += firstLine - 1;
+                }
+                expected = chunk.next;
+            } else {
+                // Resume sequentially from 'expected', positioned like the sequential lexer
+                const auto chunkStart = source.begin() + chunk.begin;
+                const auto resume = source.begin() + expected;
+                const int line = firstLine + static_cast<int>(std::count(chunkStart, resume, '\n'));
+                const auto lineStart = std::find(std::make_reverse_iterator(resume), std::make_reverse_iterator(chunkStart), '\n').base();
+                Lexer lexer(source, expected, line, static_cast<int>(resume - lineStart) + 1, false);
+                expected = lexRange(lexer, chunk.end, source.size(), out, nullptr);
+            }
+        }
+        firstLine += static_cast<int>(chunk.newlines);
+    }
+
+    // Final T_EOF, positioned at the end of the source
+    const size_t lastNewline = source.rfind('\n');
+    const int column = static_cast<int>(lastNewline == std::string_view::npos ? source.size() + 1 : source.size() - lastNewline);
+    out.push_back({TokenType::T_EOF, "EOF", firstLine, column});
+    return out;
+}
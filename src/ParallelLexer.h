@@ -0,0 +1,26 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef PARALLELLEXER_H
+#define PARALLELLEXER_H
+#include <string_view>
+#include <vector>
+
+#include "Lexer.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Lexes a large source on several threads, producing the same tokens as Lexer::tokenize()
+ *
+ * The source is split in chunks at line boundaries, each chunk is lexed speculatively as if it
+ * started outside any string, comment or extern block. The chunks are then stitched in order :
+ * a chunk is accepted from the first token where it agrees with the (already verified) previous chunks.
+ * When it never agrees (a string or a comment spans the boundary), or when it hit an error,
+ * that part is lexed again sequentially, which also reports the errors in source order.
+ *
+ * @param minChunkSize Sources smaller than two chunks are lexed sequentially
+ */
+std::vector<Token> tokenizeParallel(std::string_view source, ThreadPool& pool, size_t minChunkSize = 1 << 20);
+
+#endif //PARALLELLEXER_H
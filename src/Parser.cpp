@@ -5,105 +5,62 @@
 #include "Parser.h"
 
 #include <iostream>
-#include <map>
 
 #include "Logger.h"
-
-static int getTokenPrecedence(TokenType t) {
-    const std::map<TokenType, int> precedence = {
-        // Unary should be tested in parse primary, useless definition here
-        //{TokenType::T_Increment,    100}, // ++
-        //{TokenType::T_Decrement,    100}, // --
-        //{TokenType::T_Not,          100}, // !
-        //{TokenType::T_Complement,   100}, // ~
-
-        {TokenType::T_Mul,          90}, // *
-        {TokenType::T_Div,          90}, // /
-        {TokenType::T_Mod,          90}, // %
-
-        {TokenType::T_Add,          80}, // +
-        {TokenType::T_Sub,          80}, // -
-
-        {TokenType::T_LBitShift,    70}, // <<
-        {TokenType::T_RBitShift,    70}, // >>
-
-        {TokenType::T_GT,           60}, // >
-        {TokenType::T_GE,           60}, // >=
-        {TokenType::T_LT,           60}, // <
-        {TokenType::T_LE,           60}, // <=
-
-        {TokenType::T_Equals,       50}, // ==
-        {TokenType::T_NotEquals,    50}, // !=
-
-        {TokenType::T_BitAND,       40}, // &
-        {TokenType::T_BitXOR,       30}, // ^
-        {TokenType::T_BitOR,        20}, // |
-
-        {TokenType::T_LogAND,       15}, // &&
-        {TokenType::T_LogOR,        10}, // ||
-
-        {TokenType::T_Assign,       5},
-        {TokenType::T_AddAssign,    5},
-        {TokenType::T_SubAssign,    5},
-        {TokenType::T_MulAssign,    5},
-        {TokenType::T_DivAssign,    5},
-        {TokenType::T_ModAssign,    5},
-        {TokenType::T_AndAssign,    5},
-        {TokenType::T_XorAssign,    5},
-        {TokenType::T_OrAssign,     5},
-        {TokenType::T_LShiftAssign, 5},
-        {TokenType::T_RShiftAssign, 5}
-    };
-    auto it = precedence.find(t);
-    if (it != precedence.end()) {
-        return it->second;
-    }
-    return -1;
-}
+#include "TokenTable.h"
 
 void Parser::nextToken() {
-    index++;
-    currentToken = tokens[index];
+    splitShift = false;
+    stream.advance();
+    currentToken = &stream.current();
 }
 
-Token Parser::peek(const int offset) {
-    if (index+offset > tokens.size()) {
-        Logger::Error("Token out of bounds.");
-        exit(EXIT_FAILURE);
-    }
-    return tokens[index+offset];
+const Token& Parser::peek(const int offset) {
+    return stream.peek(offset);
 }
 
 void Parser::error(const std::string &message) {
-    Logger::Report(currentToken, message);
+    Logger::Report(*currentToken, message);
     // skips all tokens until next ;
     do {
         nextToken();
-    } while (currentToken.type != TokenType::T_Semicolon);
+    } while (currentToken->type != TokenType::T_Semicolon && currentToken->type != TokenType::T_EOF);
     eat(TokenType::T_Semicolon);
-    cout<<tokenToString(currentToken.type)+" " + currentToken.value << endl;
+    Logger::Write(tokenToString(currentToken->type) + " " + string(currentToken->value) + '\n', false);
+}
+
+// Definitions and blocks end with a '}' and take no trailing semicolon
+static bool endsWithBlock(const AST* statement) {
+    if (!statement) {
+        return false;
+    }
+    switch (statement->kind) {
+        case ASTKind::FunctionDefinition:
+        case ASTKind::Block:
+        case ASTKind::StructDefinition:
+        case ASTKind::ExtendsStatement:
+            return true;
+        default:
+            return false;
+    }
 }
 
 unique_ptr<BlockAST> Parser::parse() {
     auto block = make_unique<BlockAST>(); // The file itself is a block
-    while (currentToken.type != TokenType::T_EOF) {
+    while (currentToken->type != TokenType::T_EOF) {
         if (unique_ptr<AST> statement = parseStatement()) {
             block->statements.emplace_back(move(statement));
-            if (dynamic_cast<FunctionDefinitionAST*>(block->statements.back().get()) == nullptr &&
-                dynamic_cast<BlockAST*>(block->statements.back().get()) == nullptr &&
-                dynamic_cast<StructDefinitionAST*>(block->statements.back().get()) == nullptr &&
-                dynamic_cast<ExtendsStatementAST*>(block->statements.back().get()) == nullptr &&
-                dynamic_cast<IfStatementAST*>(block->statements.back().get()) == nullptr &&
-                dynamic_cast<ExternExprAST*>(block->statements.back().get()) == nullptr) {
+            const ASTKind kind = block->statements.back()->kind;
+            if (!endsWithBlock(block->statements.back().get()) && kind != ASTKind::IfStatement && kind != ASTKind::ExternExpr) {
                 // If it's not a function definition, block, struct, or extends statement,
                 // then it must be a statement, requires a semicolon
                 eat(TokenType::T_Semicolon);
                 }
         } else {
-            Logger::Report(currentToken, "Unexpected token at top level: " + tokenToString(currentToken.type) + ":" + currentToken.value + ".");
+            Logger::Report(*currentToken, "Unexpected token at top level: " + tokenToString(currentToken->type) + ":" + string(currentToken->value) + ".");
             nextToken();
         }
-        if (currentToken.type == TokenType::T_Semicolon)
+        if (currentToken->type == TokenType::T_Semicolon)
             eat(TokenType::T_Semicolon);
     }
     return block;
@@ -112,19 +69,15 @@ unique_ptr<BlockAST> Parser::parse() {
 unique_ptr<BlockAST> Parser::parseBlock() {
     eat(TokenType::T_LBrace);
     std::vector<unique_ptr<AST>> statements;
-    while (currentToken.type != TokenType::T_RBrace && currentToken.type != TokenType::T_EOF) {
+    while (currentToken->type != TokenType::T_RBrace && currentToken->type != TokenType::T_EOF) {
 
         if (unique_ptr<AST> statement = parseStatement()) {
             statements.emplace_back(move(statement));
-            if (dynamic_cast<FunctionDefinitionAST*>(statements.back().get()) == nullptr &&
-                dynamic_cast<BlockAST*>(statements.back().get()) == nullptr &&
-                dynamic_cast<StructDefinitionAST*>(statements.back().get()) == nullptr &&
-                dynamic_cast<ExtendsStatementAST*>(statements.back().get()) == nullptr &&
-                dynamic_cast<ExternExprAST*>(statements.back().get()) == nullptr) {
+            if (!endsWithBlock(statements.back().get()) && statements.back()->kind != ASTKind::ExternExpr) {
                 eat(TokenType::T_Semicolon);
                 }
         } else {
-            Logger::Report(currentToken, "Unexpected token inside block: " + tokenToString(currentToken.type));
+            Logger::Report(*currentToken, "Unexpected token inside block: " + tokenToString(currentToken->type));
             nextToken(); // Prevents infinite loop
         }
 
@@ -134,18 +87,31 @@ unique_ptr<BlockAST> Parser::parseBlock() {
 }
 
 void Parser::eat(const TokenType type) {
-    if (currentToken.type != type) {
-        Logger::Report(currentToken, "Found '" + tokenToString(currentToken.type) +" "+currentToken.value+ "', expected '"+ tokenToString(type)+"'.");
-        exit(EXIT_FAILURE);
+    if (currentToken->type != type) {
+        Logger::Report(*currentToken, "Found '" + tokenToString(currentToken->type) +" "+string(currentToken->value)+ "', expected '"+ tokenToString(type)+"'.");
+        throw SyntaxError();
+    }
+    nextToken();
+}
+
+bool Parser::atClosingAngle() const {
+    return currentToken->type == TokenType::T_GT || currentToken->type == TokenType::T_RBitShift;
+}
+
+void Parser::eatClosingAngle() {
+    // The lexer reads 'Box<Box<int>>' as a shift : each half of the token closes one list
+    if (currentToken->type == TokenType::T_RBitShift && !splitShift) {
+        splitShift = true;
+        return;
     }
     nextToken();
 }
 
 unique_ptr<AST> Parser::parseStatement() {
-    switch (currentToken.type) {
+    switch (currentToken->type) {
         case TokenType::T_Extern: {
-            if (currentToken.value != "extern") {
-                string val = currentToken.value;
+            if (currentToken->value != "extern") {
+                string val(currentToken->value);
                 eat(TokenType::T_Extern);
                 return make_unique<ExternExprAST>(val);
             }
@@ -179,7 +145,7 @@ unique_ptr<AST> Parser::parseStatement() {
         case TokenType::T_Int: return parseExpr();
         case TokenType::T_String: return parseString();
         default: {
-            Logger::Error("Unexpected token in statement: " + tokenToString(currentToken.type));
+            Logger::Error("Unexpected token in statement: " + tokenToString(currentToken->type));
             return nullptr;
         }
     }
@@ -199,17 +165,17 @@ unique_ptr<ExprAST> Parser::parsePostfixExpr() {
 
     // If a '.' is found, then process the method call
     while (true) {
-        if (currentToken.type == TokenType::T_Dot) {
+        if (currentToken->type == TokenType::T_Dot) {
             nextToken(); // Eat the dot
 
-            if (currentToken.type != TokenType::T_ID) {
+            if (currentToken->type != TokenType::T_ID) {
                 Logger::Error("Expected method name after '.'.");
                 return nullptr;
             }
-            std::string accessName = currentToken.value;
+            std::string accessName(currentToken->value);
             nextToken(); // eat the method name
 
-            if (currentToken.type != TokenType::T_LParen) {
+            if (currentToken->type != TokenType::T_LParen) {
                 expr = make_unique<FieldAccessAST>(move(expr), accessName);
                 continue;
             }
@@ -218,14 +184,14 @@ unique_ptr<ExprAST> Parser::parsePostfixExpr() {
 
             // Parse method args
             std::vector<unique_ptr<ExprAST>> args;
-            if (currentToken.type != TokenType::T_RParen) {
+            if (currentToken->type != TokenType::T_RParen) {
                 while (true) {
                     if (auto arg = parseExpr())
                         args.push_back(move(arg));
                     else
                         return nullptr;
 
-                    if (currentToken.type == TokenType::T_RParen)
+                    if (currentToken->type == TokenType::T_RParen)
                         break;
                     eat(TokenType::T_Comma);
                 }
@@ -243,11 +209,12 @@ unique_ptr<ExprAST> Parser::parsePostfixExpr() {
 
 unique_ptr<ExprAST> Parser::parseOpRHS(const int exprPrecedence, unique_ptr<ExprAST> LHS) {
     while (true) {
-        int precedence = getTokenPrecedence(currentToken.type);
+        const TokenInfo& info = tokenInfo(currentToken->type);
+        const int precedence = info.precedence;
         if (precedence < exprPrecedence)
             return LHS;
 
-        auto op = currentToken.type;
+        auto op = currentToken->type;
         nextToken(); // eat the operator
 
         // If it's a simple assignment, create a specific AST node for it.
@@ -262,8 +229,11 @@ unique_ptr<ExprAST> Parser::parseOpRHS(const int exprPrecedence, unique_ptr<Expr
         if (!RHS)
             return nullptr;
 
-        if (const int nextPrecedence = getTokenPrecedence(currentToken.type); precedence < nextPrecedence) {
-            RHS = parseOpRHS(precedence + 1, move(RHS));
+        // Binds tighter operators first, and operators of the same precedence if right associative
+        const int nextPrecedence = tokenInfo(currentToken->type).precedence;
+        if (const bool rightAssoc = info.associativity == Associativity::Right;
+            precedence < nextPrecedence || (rightAssoc && precedence == nextPrecedence)) {
+            RHS = parseOpRHS(rightAssoc ? precedence : precedence + 1, move(RHS));
             if (!RHS)
                 return nullptr;
         }
@@ -274,7 +244,7 @@ unique_ptr<ExprAST> Parser::parseOpRHS(const int exprPrecedence, unique_ptr<Expr
 
 // Identifier - Number - String - (Expression)
 unique_ptr<ExprAST> Parser::parsePrimary() {
-    switch (currentToken.type) {
+    switch (currentToken->type) {
         case TokenType::T_ID:     return parseIdentifierExpr(); // VariableExprAST or CallExprAST
         case TokenType::T_Float:  return parseFloatExpr();
         case TokenType::T_Int:    return parseIntExpr();
@@ -289,14 +259,14 @@ unique_ptr<ExprAST> Parser::parsePrimary() {
         case TokenType::T_Decrement:
             return parseUnaryExpr();
         case TokenType::T_Extern: {
-            if (currentToken.value != "extern") {
-                string val = currentToken.value;
+            if (currentToken->value != "extern") {
+                string val(currentToken->value);
                 eat(TokenType::T_Extern);
                 return make_unique<ExternExprAST>(val);
             }
         }
         default: {
-            Logger::Error("Expected an expression, found '" + tokenToString(currentToken.type) + "'.");
+            Logger::Error("Expected an expression, found '" + tokenToString(currentToken->type) + "'.");
             nextToken();
             return nullptr;
         }
@@ -304,7 +274,7 @@ unique_ptr<ExprAST> Parser::parsePrimary() {
 }
 
 unique_ptr<ExprAST> Parser::parseUnaryExpr() {
-    TokenType op = currentToken.type;
+    TokenType op = currentToken->type;
     nextToken(); // Eat the operator
     auto operand = parsePrimary();
     if (!operand) return nullptr;
@@ -313,19 +283,19 @@ unique_ptr<ExprAST> Parser::parseUnaryExpr() {
 
 // TODO : add more number types
 unique_ptr<FloatExprAST> Parser::parseFloatExpr() {
-    auto res = make_unique<FloatExprAST>(stof(currentToken.value));
+    auto res = make_unique<FloatExprAST>(stof(string(currentToken->value)));
     eat(TokenType::T_Float);
     return move(res);
 }
 
 unique_ptr<IntExprAST> Parser::parseIntExpr() {
-    auto res = make_unique<IntExprAST>(stoi(currentToken.value));
+    auto res = make_unique<IntExprAST>(stoi(string(currentToken->value)));
     eat(TokenType::T_Int);
     return move(res);
 }
 
 unique_ptr<StringExprAST> Parser::parseString() {
-    string value = currentToken.value;
+    string value(currentToken->value);
     eat(TokenType::T_String);
     return make_unique<StringExprAST>(value);
 }
@@ -333,7 +303,7 @@ unique_ptr<StringExprAST> Parser::parseString() {
 // (Expression) - ()
 unique_ptr<ExprAST> Parser::parseParenExpr() {
     eat(TokenType::T_LParen);
-    if (currentToken.type == TokenType::T_RParen) {
+    if (currentToken->type == TokenType::T_RParen) {
         eat(TokenType::T_RParen);
         return nullptr;
     }
@@ -346,20 +316,20 @@ unique_ptr<ExprAST> Parser::parseParenExpr() {
 
 // Identifier - Identifier(...)
 unique_ptr<ExprAST> Parser::parseIdentifierExpr() {
-    std::string name = currentToken.value;
+    std::string name(currentToken->value);
     eat(TokenType::T_ID);
 
-    if (currentToken.type == TokenType::T_LParen) { // Function call if LParen found
+    if (currentToken->type == TokenType::T_LParen) { // Function call if LParen found
         eat(TokenType::T_LParen);
         std::vector<unique_ptr<ExprAST>> args;
-        if (currentToken.type != TokenType::T_RParen) {
+        if (currentToken->type != TokenType::T_RParen) {
             while (true) {
                 if (auto arg = parseExpr()) // Parses arguments
                     args.push_back(move(arg));
                 else
                     return nullptr;
 
-                if (currentToken.type == TokenType::T_RParen)
+                if (currentToken->type == TokenType::T_RParen)
                     break;
                 eat(TokenType::T_Comma);
             }
@@ -375,11 +345,11 @@ unique_ptr<ExprAST> Parser::parseIdentifierExpr() {
 unique_ptr<ExternStatementAST> Parser::parseExternStatement() {
     eat(TokenType::T_Extern);
 
-    if (currentToken.type != TokenType::T_ID) {
+    if (currentToken->type != TokenType::T_ID) {
         Logger::Error("Expected library name after 'extern'.");
         return nullptr;
     }
-    std::string libName = currentToken.value;
+    std::string libName(currentToken->value);
     eat(TokenType::T_ID);
 
     return make_unique<ExternStatementAST>(libName);
@@ -387,42 +357,42 @@ unique_ptr<ExternStatementAST> Parser::parseExternStatement() {
 
 // TODO : type with generics parsing (Type<A,B>)
 unique_ptr<TypeAST> Parser::parseType() {
-    if (currentToken.type != TokenType::T_ID) {
-        Logger::Report(currentToken, "Expected a type name.");
+    if (currentToken->type != TokenType::T_ID) {
+        Logger::Report(*currentToken, "Expected a type name.");
         return nullptr;
     }
-    string baseTypeName = currentToken.value;
+    string baseTypeName(currentToken->value);
     eat(TokenType::T_ID);
 
-    if (currentToken.type == TokenType::T_LT) {
+    if (currentToken->type == TokenType::T_LT) {
         eat(TokenType::T_LT);
         vector<unique_ptr<TypeAST>> genericArgs;
-        while (currentToken.type != TokenType::T_GT) {
+        while (!atClosingAngle()) {
             if (auto argType = parseType()) {
                 genericArgs.push_back(move(argType));
             } else {
                 return nullptr; // Error while parsing the generic argument
             }
-            if (currentToken.type == TokenType::T_Comma) {
+            if (currentToken->type == TokenType::T_Comma) {
                 eat(TokenType::T_Comma);
-            } else if (currentToken.type != TokenType::T_GT) {
+            } else if (!atClosingAngle()) {
                 Logger::Error("Expected ',' or '>' in generic parameter list.");
                 return nullptr;
             }
         }
-        eat(TokenType::T_GT);
+        eatClosingAngle();
         return make_unique<TypeAST>(baseTypeName, move(genericArgs));
     }
 
     return make_unique<TypeAST>(baseTypeName);
 
     // Parse array : [type] or [type, size]
-    /*if (currentToken.type == TokenType::T_LBracket) {
+    /*if (currentToken->type == TokenType::T_LBracket) {
         eat(TokenType::T_LBracket);
         unique_ptr<ExprAST> arraySize = nullptr;
-        if (currentToken.type != TokenType::T_RBracket) {
+        if (currentToken->type != TokenType::T_RBracket) {
             // Check if there's an explicit size
-            if (currentToken.type != TokenType::T_ID && currentToken.type != TokenType::T_Int) {
+            if (currentToken->type != TokenType::T_ID && currentToken->type != TokenType::T_Int) {
                 Logger::Error("Expected type or size in array declaration.");
                 return nullptr;
             }
@@ -431,7 +401,7 @@ unique_ptr<TypeAST> Parser::parseType() {
         eat(TokenType::T_RBracket);
         return make_unique<TypeAST>(std::move(baseTypeName), std::move(arraySize));
     }
-    Logger::Report(currentToken, "Expected a type.");
+    Logger::Report(*currentToken, "Expected a type.");
     return nullptr;*/
 }
 
@@ -441,12 +411,12 @@ unique_ptr<FunctionParameterAST> Parser::parseFunctionParameter() {
     if (!type) return nullptr;
     // comment needed, because of stranger IDE warning
     // ReSharper disable once CppDFAConstantConditions
-    if (currentToken.type != TokenType::T_ID) {
+    if (currentToken->type != TokenType::T_ID) {
         Logger::Error("Expected parameter name.");
         return nullptr;
     }
     // ReSharper disable once CppDFAUnreachableCode
-    std::string name = currentToken.value;
+    std::string name(currentToken->value);
     eat(TokenType::T_ID);
     return make_unique<FunctionParameterAST>(std::move(type), name);
 }
@@ -456,32 +426,32 @@ unique_ptr<FunctionDefinitionAST> Parser::parseFunctionDefinition(bool isStatic=
     auto returnType = parseType();
     if (!returnType) return nullptr;
 
-    if (currentToken.type != TokenType::T_ID) {
+    if (currentToken->type != TokenType::T_ID) {
         Logger::Error("Expected function name.");
         return nullptr;
     }
-    std::string funcName = currentToken.value;
+    std::string funcName(currentToken->value);
     eat(TokenType::T_ID);
 
     eat(TokenType::T_LParen);
     std::vector<unique_ptr<FunctionParameterAST>> params;
-    if (currentToken.type != TokenType::T_RParen) {
+    if (currentToken->type != TokenType::T_RParen) {
         while (true) {
             if (auto param = parseFunctionParameter()) {
                 params.push_back(std::move(param));
             } else {
                 return nullptr;
             }
-            if (currentToken.type == TokenType::T_RParen) break;
+            if (currentToken->type == TokenType::T_RParen) break;
             eat(TokenType::T_Comma);
         }
     }
     eat(TokenType::T_RParen);
 
     unique_ptr<AST> body = nullptr;
-    if (currentToken.type == TokenType::T_LBrace) {
+    if (currentToken->type == TokenType::T_LBrace) {
         body = parseBlock(); // A block for multi-statement functions
-    } else if (currentToken.type == TokenType::T_Assign) {
+    } else if (currentToken->type == TokenType::T_Assign) {
         eat(TokenType::T_Assign);
         body = parseExpr(); // A single expression for ' = ' functions
     } else {
@@ -493,18 +463,18 @@ unique_ptr<FunctionDefinitionAST> Parser::parseFunctionDefinition(bool isStatic=
 
 // function(params...)
 unique_ptr<FunctionCallAST> Parser::parseFunctionCall() {
-    std::string funcName = currentToken.value;
+    std::string funcName(currentToken->value);
     eat(TokenType::T_ID);
 
     eat(TokenType::T_LParen);
     std::vector<unique_ptr<ExprAST>> params;
-    if (currentToken.type != TokenType::T_RParen) {
+    if (currentToken->type != TokenType::T_RParen) {
         while (true) {
             if (auto param = parseExpr())
                 params.push_back(std::move(param));
             else
                 return nullptr;
-            if (currentToken.type == TokenType::T_RParen) break;
+            if (currentToken->type == TokenType::T_RParen) break;
             eat(TokenType::T_Comma);
         }
     }
@@ -520,15 +490,15 @@ unique_ptr<VariableDeclarationAST> Parser::parseVariableDeclaration() {
     if (!varType)
         return nullptr;
 
-    if (currentToken.type != TokenType::T_ID) {
+    if (currentToken->type != TokenType::T_ID) {
         Logger::Error("Expected variable name.");
         return nullptr;
     }
-    std::string varName = currentToken.value;
+    std::string varName(currentToken->value);
     eat(TokenType::T_ID);
 
     unique_ptr<ExprAST> initializer = nullptr;
-    if (currentToken.type == TokenType::T_Assign) {
+    if (currentToken->type == TokenType::T_Assign) {
         eat(TokenType::T_Assign);
         initializer = parseExpr();
         if (!initializer) return nullptr;
@@ -539,26 +509,26 @@ unique_ptr<VariableDeclarationAST> Parser::parseVariableDeclaration() {
 // struct name {fields...} - struct name<A,B> {fields...}
 unique_ptr<StructDefinitionAST> Parser::parseStructDefinition() {
     eat(TokenType::T_Struct);
-    if (currentToken.type != TokenType::T_ID) {
+    if (currentToken->type != TokenType::T_ID) {
         Logger::Error("Expected struct name.");
         return nullptr;
     }
-    std::string structName = currentToken.value;
+    std::string structName(currentToken->value);
     eat(TokenType::T_ID);
 
     std::vector<unique_ptr<GenericParameterAST>> genericParams;
-    if (currentToken.type == TokenType::T_LT) { // Generics
+    if (currentToken->type == TokenType::T_LT) { // Generics
         eat(TokenType::T_LT);
-        while (currentToken.type != TokenType::T_GT) {
-            if (currentToken.type != TokenType::T_ID) {
+        while (currentToken->type != TokenType::T_GT) {
+            if (currentToken->type != TokenType::T_ID) {
                 Logger::Error("Expected generic parameter name.");
                 return nullptr;
             }
-            genericParams.push_back(make_unique<GenericParameterAST>(currentToken.value));
+            genericParams.push_back(make_unique<GenericParameterAST>(string(currentToken->value)));
             eat(TokenType::T_ID);
-            if (currentToken.type == TokenType::T_Comma) {
+            if (currentToken->type == TokenType::T_Comma) {
                 eat(TokenType::T_Comma);
-            } else if (currentToken.type != TokenType::T_GT) {
+            } else if (currentToken->type != TokenType::T_GT) {
                 Logger::Error("Expected ',' or '>' in generic parameter list.");
                 return nullptr;
             }
@@ -568,18 +538,18 @@ unique_ptr<StructDefinitionAST> Parser::parseStructDefinition() {
 
     eat(TokenType::T_LBrace);
     std::vector<unique_ptr<StructFieldAST>> fields;
-    while (currentToken.type != TokenType::T_RBrace) {
+    while (currentToken->type != TokenType::T_RBrace) {
         auto fieldType = parseType();
         if (!fieldType) return nullptr;
 
         // Comment needed because of strange IDE warning
         // ReSharper disable once CppDFAConstantConditions
-        if (currentToken.type != TokenType::T_ID) {
+        if (currentToken->type != TokenType::T_ID) {
             Logger::Error("Expected field name.");
             return nullptr;
         }
         // ReSharper disable once CppDFAUnreachableCode
-        std::string fieldName = currentToken.value;
+        std::string fieldName(currentToken->value);
         eat(TokenType::T_ID);
         eat(TokenType::T_Semicolon); // Each field declaration ends with a semicolon
         fields.push_back(make_unique<StructFieldAST>(std::move(fieldType), fieldName));
@@ -593,23 +563,23 @@ unique_ptr<ConstructorDefinitionAST> Parser::parseConstructorDefinition() {
     eat(TokenType::T_Constructor);
     eat(TokenType::T_LParen);
     std::vector<unique_ptr<FunctionParameterAST>> params;
-    if (currentToken.type != TokenType::T_RParen) {
+    if (currentToken->type != TokenType::T_RParen) {
         while (true) {
             if (auto param = parseFunctionParameter()) {
                 params.push_back(std::move(param));
             } else {
                 return nullptr;
             }
-            if (currentToken.type == TokenType::T_RParen) break;
+            if (currentToken->type == TokenType::T_RParen) break;
             eat(TokenType::T_Comma);
         }
     }
     eat(TokenType::T_RParen);
 
     unique_ptr<AST> body;
-    if (currentToken.type == TokenType::T_LBrace) {
+    if (currentToken->type == TokenType::T_LBrace) {
         body = parseBlock(); // A block for multi-statement functions
-    } else if (currentToken.type == TokenType::T_Assign) {
+    } else if (currentToken->type == TokenType::T_Assign) {
         eat(TokenType::T_Assign);
         body = parseExpr(); // A single expression for ' = ' functions
     } else {
@@ -622,19 +592,19 @@ unique_ptr<ConstructorDefinitionAST> Parser::parseConstructorDefinition() {
 
 // extends SomeStruct{} - childStruct extends SomeStruct {}
 unique_ptr<ExtendsStatementAST> Parser::parseExtendsStatement() {
-    if (currentToken.type == TokenType::T_ID) { // inheritance case (B extends A {})
-        std::string childName = currentToken.value;
+    if (currentToken->type == TokenType::T_ID) { // inheritance case (B extends A {})
+        std::string childName(currentToken->value);
         eat(TokenType::T_ID);
-        if (currentToken.type != TokenType::T_Extends) {
+        if (currentToken->type != TokenType::T_Extends) {
             Logger::Error("Expected 'extends' after child struct name.");
             return nullptr;
         }
         eat(TokenType::T_Extends);
-        if (currentToken.type != TokenType::T_ID) {
+        if (currentToken->type != TokenType::T_ID) {
             Logger::Error("Expected parent struct name after 'extends'.");
             return nullptr;
         }
-        std::string parentName = currentToken.value;
+        std::string parentName(currentToken->value);
         eat(TokenType::T_ID);
         const auto body = parseBlock();
         return make_unique<ExtendsStatementAST>(childName, parentName, move(body->statements));
@@ -642,11 +612,11 @@ unique_ptr<ExtendsStatementAST> Parser::parseExtendsStatement() {
 
     // else: simple struct extending
     eat(TokenType::T_Extends);
-    if (currentToken.type != TokenType::T_ID) {
+    if (currentToken->type != TokenType::T_ID) {
         Logger::Error("Expected struct name to extend.");
         return nullptr;
     }
-    std::string structName = currentToken.value;
+    std::string structName(currentToken->value);
     eat(TokenType::T_ID);
 
     const auto body = parseBlock();
@@ -656,7 +626,7 @@ unique_ptr<ExtendsStatementAST> Parser::parseExtendsStatement() {
 // return Expression
 unique_ptr<ReturnAST> Parser::parseReturn() {
     eat(TokenType::T_Return);
-    if (currentToken.type == TokenType::T_Semicolon) {
+    if (currentToken->type == TokenType::T_Semicolon) {
         return make_unique<ReturnAST>(nullptr);
     }
     auto ret = parseExpr();
@@ -674,14 +644,11 @@ unique_ptr<IfStatementAST> Parser::parseIfStatement() {
     }
 
     unique_ptr<AST> thenBody;
-    if (currentToken.type == TokenType::T_LBrace) {
+    if (currentToken->type == TokenType::T_LBrace) {
         thenBody = parseBlock();
     } else {
         thenBody = parseStatement();
-        if (dynamic_cast<FunctionDefinitionAST*>(thenBody.get()) == nullptr &&
-            dynamic_cast<BlockAST*>(thenBody.get()) == nullptr &&
-            dynamic_cast<StructDefinitionAST*>(thenBody.get()) == nullptr &&
-            dynamic_cast<ExtendsStatementAST*>(thenBody.get()) == nullptr) {
+        if (!endsWithBlock(thenBody.get())) {
             eat(TokenType::T_Semicolon);
             }
     }
@@ -689,17 +656,14 @@ unique_ptr<IfStatementAST> Parser::parseIfStatement() {
         error("Expected body after 'if' condition.");
         return nullptr;
     }
-    if (currentToken.type == TokenType::T_Else) {
+    if (currentToken->type == TokenType::T_Else) {
         eat(TokenType::T_Else);
         unique_ptr<AST> elseBody;
-        if (currentToken.type == TokenType::T_LBrace) {
+        if (currentToken->type == TokenType::T_LBrace) {
             elseBody = parseBlock();
         } else {
             elseBody = parseStatement();
-            if (dynamic_cast<FunctionDefinitionAST*>(elseBody.get()) == nullptr &&
-                dynamic_cast<BlockAST*>(elseBody.get()) == nullptr &&
-                dynamic_cast<StructDefinitionAST*>(elseBody.get()) == nullptr &&
-                dynamic_cast<ExtendsStatementAST*>(elseBody.get()) == nullptr) {
+            if (!endsWithBlock(elseBody.get())) {
                 eat(TokenType::T_Semicolon);
                 }
         }
@@ -10,19 +10,26 @@
 
 #include "AST.h"
 #include "Lexer.h"
+#include "TokenStream.h"
 
 using namespace std;
 
 
 class Parser {
-    std::vector<Token> tokens;
-    Token currentToken = tokens[0];
-    int index = 0;
+    TokenStream stream;
+    const Token* currentToken = &stream.current(); // Points into the stream, never copied
+    bool splitShift = false; // The first '>' of the current '>>' token closed a generic argument list
     void nextToken();
-    Token peek(int offset);
+    const Token& peek(int offset);
+    // '>' closing a generic argument list, '>>' closes two nested ones
+    [[nodiscard]] bool atClosingAngle() const;
+    void eatClosingAngle();
 public:
     void error(const std::string &message);
-    explicit Parser(std::vector<Token> tokens) : tokens(std::move(tokens)) {}
+    // Parses an already lexed token vector
+    explicit Parser(std::vector<Token> tokens) : stream(std::move(tokens)) {}
+    // Pulls the tokens from the lexer while parsing, only the lookahead is kept in memory
+    explicit Parser(Lexer& lexer) : stream(lexer) {}
     unique_ptr<BlockAST> parse();
     unique_ptr<BlockAST> parseBlock();
     unique_ptr<AST> parseStatement();
@@ -0,0 +1,162 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "PassManager.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+
+void PassManager::addPass(const string& name, const vector<string>& dependencies, const vector<string>& importDependencies,
+                          ModulePass pass, const Execution execution) {
+    const auto indices = [&](const vector<string>& names) {
+        vector<size_t> result;
+        for (const auto& dependency : names) {
+            // A pass can wait for itself on the imports
+            result.push_back(dependency == name ? passes.size() : indexOf(dependency));
+        }
+        return result;
+    };
+    passes.push_back({name, indices(dependencies), indices(importDependencies), move(pass), execution});
+}
+
+size_t PassManager::indexOf(const string& pass) const {
+    for (size_t i = 0; i < passes.size(); i++) {
+        if (passes[i].name == pass) return i;
+    }
+    throw invalid_argument("Unknown pass '" + pass + "'.");
+}
+
+vector<PassManager::Status>& PassManager::statusOf(const string& module) {
+    auto& state = status[module];
+    state.resize(passes.size(), Status::Pending);
+    return state;
+}
+
+void PassManager::markDone(const string& module, const string& pass) {
+    statusOf(module)[indexOf(pass)] = Status::Done;
+}
+
+void PassManager::requiredPasses(const size_t pass, vector<bool>& required) const {
+    if (required[pass]) return;
+    required[pass] = true;
+    for (const size_t dependency : passes[pass].dependencies) {
+        requiredPasses(dependency, required);
+    }
+    for (const size_t dependency : passes[pass].importDependencies) {
+        requiredPasses(dependency, required);
+    }
+}
+
+bool PassManager::ready(const string& module, const size_t pass) {
+    const auto& state = statusOf(module);
+    for (const size_t dependency : passes[pass].dependencies) {
+        if (state[dependency] != Status::Done) return false;
+    }
+    for (const auto& imported : graph.dependencies(module)) {
+        const auto it = modules.find(imported);
+        if (it == modules.end() || !it->second) continue;
+        const auto& importedState = statusOf(imported);
+        for (const size_t dependency : passes[pass].importDependencies) {
+            if (importedState[dependency] != Status::Done) return false;
+        }
+    }
+    return true;
+}
+
+void PassManager::run(const string& pass) {
+    vector<bool> required(passes.size(), false);
+    requiredPasses(indexOf(pass), required);
+
+    // Every pass left to run on a module, in the order the serial ones run
+    struct Task {
+        size_t pass;
+        const string* module;
+        unique_ptr<BlockAST>* ast;
+    };
+    vector<Task> tasks;
+    for (size_t index = 0; index < passes.size(); index++) {
+        if (!required[index]) continue;
+        for (auto& [module, ast] : modules) {
+            if (ast && statusOf(module)[index] == Status::Pending) {
+                tasks.push_back({index, &module, &ast});
+            }
+        }
+    }
+    ranges::stable_sort(tasks, {}, [&](const Task& task) { return pair(task.pass, graph.rank(*task.module)); });
+
+    mutex mutex;
+    condition_variable finished;
+    size_t running = 0;
+    vector<future<void>> concurrent;
+    const auto execute = [&](const Task& task) {
+        const auto start = chrono::steady_clock::now();
+        passes[task.pass].run(*task.module, *task.ast);
+        const auto time = chrono::steady_clock::now() - start;
+        lock_guard lock(mutex);
+        statusOf(*task.module)[task.pass] = Status::Done;
+        passes[task.pass].time += time;
+        passes[task.pass].modulesRun++;
+    };
+
+    unique_lock lock(mutex);
+    while (true) {
+        const Task* serial = nullptr;
+        for (const auto& task : tasks) {
+            if (statusOf(*task.module)[task.pass] != Status::Pending || !ready(*task.module, task.pass)) continue;
+            if (passes[task.pass].execution == Execution::Concurrent && pool) {
+                statusOf(*task.module)[task.pass] = Status::Running;
+                running++;
+                concurrent.push_back(pool->submit([&] {
+                    const auto finish = [&] {
+                        lock_guard done(mutex);
+                        running--;
+                        finished.notify_one();
+                    };
+                    try {
+                        execute(task);
+                    } catch (...) {
+                        // Its dependents never become ready, the exception is rethrown once the others are done
+                        finish();
+                        throw;
+                    }
+                    finish();
+                }));
+            } else if (!serial) {
+                serial = &task;
+            }
+        }
+        if (serial) {
+            statusOf(*serial->module)[serial->pass] = Status::Running;
+            lock.unlock();
+            execute(*serial);
+            lock.lock();
+            continue;
+        }
+        if (running == 0) break;
+        finished.wait(lock);
+    }
+    lock.unlock();
+    // Rethrows what a concurrent pass may have thrown
+    for (auto& task : concurrent) {
+        task.get();
+    }
+}
+
+void PassManager::printTimings(ostream& out) const {
+    out << "Pass timings :" << endl;
+    chrono::steady_clock::duration total {};
+    for (const auto& pass : passes) {
+        if (pass.modulesRun == 0) continue;
+        total += pass.time;
+        out << "  " << left << setw(10) << pass.name << right << fixed << setprecision(3)
+            << setw(10) << chrono::duration<double, milli>(pass.time).count() << " ms  ("
+            << pass.modulesRun << (pass.modulesRun == 1 ? " module)" : " modules)") << endl;
+    }
+    out << "  " << left << setw(10) << "total" << right << fixed << setprecision(3)
+        << setw(10) << chrono::duration<double, milli>(total).count() << " ms" << endl;
+}
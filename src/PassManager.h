@@ -0,0 +1,84 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef PASSMANAGER_H
+#define PASSMANAGER_H
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "AST.h"
+#include "ModuleGraph.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * @brief Runs the compiler passes over the modules, each pass exactly once per module
+ *
+ * A pass runs on a module as soon as the passes it depends on have run on that module, and
+ * its import dependencies have run on every module it imports (see ModuleGraph) : the analysis
+ * of a module waits for the analysis of its imports, its code generation only for its own analysis,
+ * the compilation of its C for the headers of its imports to be generated.
+ * Serial passes run on the calling thread, lower passes first then in import order, so all the
+ * modules are pre-passed before any is analysed. Concurrent passes are submitted to the pool
+ * as soon as they are ready, and overlap with the serial passes of the other modules.
+ * Modules added after a pass ran (ex : the generic instantiations) only get the passes not
+ * marked as already done for them.
+ */
+class PassManager {
+public:
+    using ModulePass = function<void(const string& module, unique_ptr<BlockAST>& ast)>;
+
+    enum class Execution { Serial, Concurrent };
+
+    // Concurrent passes run on the calling thread too when there is no pool
+    PassManager(map<string, unique_ptr<BlockAST>>& modules, const ModuleGraph& graph, ThreadPool* pool = nullptr)
+        : modules(modules), graph(graph), pool(pool) {}
+
+    // 'dependencies' must have run on the module itself, 'importDependencies' on every module it imports
+    void addPass(const string& name, const vector<string>& dependencies, const vector<string>& importDependencies,
+                 ModulePass pass, Execution execution = Execution::Serial);
+
+    // Records that 'pass' already ran on 'module' by other means
+    void markDone(const string& module, const string& pass);
+
+    // Runs 'pass' and its dependencies on every module they have not run on yet
+    void run(const string& pass);
+
+    // Total time and number of modules of every pass that ran
+    void printTimings(ostream& out) const;
+
+private:
+    struct Pass {
+        string name;
+        vector<size_t> dependencies;
+        vector<size_t> importDependencies;
+        ModulePass run;
+        Execution execution;
+        chrono::steady_clock::duration time {};
+        size_t modulesRun = 0;
+    };
+
+    // State of a pass on a module, for the scheduler
+    enum class Status : uint8_t { Pending, Running, Done };
+
+    map<string, unique_ptr<BlockAST>>& modules;
+    const ModuleGraph& graph;
+    ThreadPool* pool;
+    vector<Pass> passes;                // Declaration order, dependencies come first
+    map<string, vector<Status>> status; // module -> pass index -> status
+
+    size_t indexOf(const string& pass) const;
+    vector<Status>& statusOf(const string& module);
+    void requiredPasses(size_t pass, vector<bool>& required) const;
+    [[nodiscard]] bool ready(const string& module, size_t pass);
+};
+
+#endif //PASSMANAGER_H
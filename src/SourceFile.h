@@ -0,0 +1,47 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef SOURCEFILE_H
+#define SOURCEFILE_H
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Read-only view over the content of a source file
+ *
+ * Regular files are memory mapped, so the Lexer reads the page cache directly
+ * without any copy. Anything that can not be mapped (pipes, special files, empty files)
+ * falls back to a buffered read into an owned string.
+ * The view stays valid as long as the SourceFile is alive.
+ */
+class SourceFile {
+    std::string path;
+    const char* mapping = nullptr;
+    size_t size = 0;
+    std::string buffer; // Fallback storage when the file is not mapped
+    bool opened = false;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    bool map();
+    bool read();
+    void unmap();
+
+public:
+    explicit SourceFile(std::string path);
+    ~SourceFile();
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    [[nodiscard]] bool isOpen() const { return opened; }
+    [[nodiscard]] bool isMapped() const { return mapping != nullptr; }
+    [[nodiscard]] const std::string& getPath() const { return path; }
+    [[nodiscard]] std::string_view view() const {
+        return mapping ? std::string_view(mapping, size) : std::string_view(buffer);
+    }
+};
+
+#endif //SOURCEFILE_H
@@ -0,0 +1,34 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef SYMBOLINFO_H
+#define SYMBOLINFO_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "TypeTable.h"
+
+class AST;
+
+struct SymbolInfo {
+    enum SymbolType {
+        Function, Structure, Variable, Generic, Type
+    };
+    TypeId type;
+    SymbolType metaType;
+    bool isStatic;
+    bool constant;
+    const AST* declaration = nullptr; // Node declaring the symbol, null for the builtins
+    uint32_t position = 0;            // Set by the SymbolTable, see SymbolTable::position
+};
+
+// Function, method or constructor declaration, see SymbolTable::addOverload
+struct Overload {
+    std::vector<TypeId> params;
+    SymbolInfo symbol;  // Return type and declaration
+    std::string cName;  // Name of the generated C function
+};
+
+#endif //SYMBOLINFO_H
@@ -3,9 +3,188 @@
 //
 
 #include "SymbolTable.h"
+
+#include <algorithm>
+
 #include "AST.h"
+#include "Monomorphizer.h"
 
 void SymbolTable::registerGeneric(unique_ptr<AST> ast) const {
     // This line requires BlockAST to be fully defined for generics->statements.push_back
     generics->statements.push_back(move(ast));
 }
+
+size_t SymbolTable::InstantiationHash::operator()(const InstantiationKey& key) const noexcept {
+    size_t hash = std::hash<const void*>{}(key.genericTemplate);
+    for (const TypeId arg : key.args) {
+        hash = hash * 1099511628211u ^ arg.index();
+    }
+    return hash;
+}
+
+size_t SymbolTable::InstantiationHash::operator()(const InstantiationArgs& key) const noexcept {
+    size_t hash = std::hash<const void*>{}(key.genericTemplate);
+    for (const auto& arg : key.args) {
+        hash = hash * 1099511628211u ^ arg->id().index();
+    }
+    return hash;
+}
+
+bool SymbolTable::InstantiationEqual::operator()(const InstantiationKey& a, const InstantiationKey& b) const noexcept {
+    return a.genericTemplate == b.genericTemplate && a.args == b.args;
+}
+
+bool SymbolTable::InstantiationEqual::operator()(const InstantiationArgs& a, const InstantiationKey& b) const noexcept {
+    return a.genericTemplate == b.genericTemplate && ranges::equal(a.args, b.args, {}, &TypeAST::id);
+}
+
+const StructDefinitionAST* SymbolTable::lookupInstantiation(const StructDefinitionAST* genericTemplate, const TypeAST& type) const {
+    if (globals) return globals->lookupInstantiation(genericTemplate, type);
+    const auto it = instantiations.find(InstantiationArgs{genericTemplate, type.genericArgs});
+    return it != instantiations.end() ? it->second : nullptr;
+}
+
+void SymbolTable::addInstantiation(const StructDefinitionAST* genericTemplate, const TypeAST& type, const StructDefinitionAST* instance) {
+    vector<TypeId> args;
+    args.reserve(type.genericArgs.size());
+    for (const auto& arg : type.genericArgs) {
+        args.push_back(arg->id());
+    }
+    instantiations.emplace(InstantiationKey{genericTemplate, move(args)}, instance);
+}
+
+void SymbolTable::exitScope() {
+    if (scopeStarts.size() <= 1) return;
+    const uint32_t start = scopeStarts.back();
+    scopeStarts.pop_back();
+    // Unwind in reverse, so a name bound twice in the scope gets its outer binding back
+    while (bindings.size() > start) {
+        const Binding& binding = bindings.back();
+        visible[binding.name.index()] = binding.shadowed;
+        bindings.pop_back();
+    }
+}
+
+void SymbolTable::reset(const SymbolTable& newGlobals, InstantiationQueue& newRequests, const size_t newTask, const uint32_t newPosition) {
+    globals = &newGlobals;
+    requests = &newRequests;
+    task = newTask;
+    position = newPosition;
+    // The body may have returned without leaving its scopes
+    while (!bindings.empty()) {
+        visible[bindings.back().name.index()] = bindings.back().shadowed;
+        bindings.pop_back();
+    }
+    scopeStarts.assign(1, 0);
+}
+
+bool SymbolTable::addSymbol(const NameId name, const SymbolInfo& info) {
+    if (scopeStarts.empty()) return false;
+    if (name.index() >= visible.size()) {
+        visible.resize(name.index() + 1, NoBinding);
+    }
+    uint32_t& innermost = visible[name.index()];
+    if (innermost != NoBinding && innermost >= scopeStarts.back()) {
+        // Can be added if the meta type is different
+        // ex : function named 'a' can be added even if there exists a variable 'a'
+        if (bindings[innermost].info.metaType == info.metaType) {
+            return false;
+        }
+        bindings[innermost].info = info;
+        bindings[innermost].info.position = position;
+        return true;
+    }
+    bindings.push_back({name, info, innermost});
+    bindings.back().info.position = position;
+    innermost = static_cast<uint32_t>(bindings.size() - 1);
+    return true;
+}
+
+bool SymbolTable::addStruct(const NameId structName, const StructFieldMap& structFields) {
+    if (!knownStructs.insert(structName).second) {
+        return false; // Déjà définie
+    }
+    for (const auto& [field, info] : structFields) {
+        SymbolInfo& stored = fields[fieldKey(structName, field)];
+        stored = info;
+        stored.position = position;
+    }
+    return true;
+}
+
+bool SymbolTable::addOverload(const TypeId owner, const NameId name, Overload overload) {
+    auto& byArity = overloads[overloadKey(owner, name)];
+    if (overload.params.size() >= byArity.size()) {
+        byArity.resize(overload.params.size() + 1);
+    }
+    auto& candidates = byArity[overload.params.size()];
+    for (const auto& candidate : candidates) {
+        if (candidate.params == overload.params) {
+            return false;
+        }
+    }
+    overload.symbol.position = position;
+    candidates.push_back(move(overload));
+    return true;
+}
+
+const Overload* SymbolTable::resolve(const TypeId owner, const NameId name, const std::span<const TypeId> args) const {
+    return globals ? globals->resolve(owner, name, args, position) : resolve(owner, name, args, AllPositions);
+}
+
+const Overload* SymbolTable::resolve(const TypeId owner, const NameId name, const std::span<const TypeId> args, const uint32_t limit) const {
+    const auto it = overloads.find(overloadKey(owner, name));
+    if (it == overloads.end() || args.size() >= it->second.size()) {
+        return nullptr;
+    }
+    for (const auto& candidate : it->second[args.size()]) {
+        if (std::ranges::equal(candidate.params, args)) {
+            return candidate.symbol.position <= limit ? &candidate : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<SymbolInfo> SymbolTable::lookupSymbol(const NameId name, const uint32_t limit) const {
+    if (name.index() >= visible.size()) return std::nullopt;
+    // Bindings declared after the limit are skipped, for what they shadow
+    for (uint32_t binding = visible[name.index()]; binding != NoBinding; binding = bindings[binding].shadowed) {
+        if (bindings[binding].info.position <= limit) {
+            return bindings[binding].info;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<SymbolInfo> SymbolTable::lookupField(const NameId structName, const NameId fieldName, const uint32_t limit) const {
+    if (const auto it = fields.find(fieldKey(structName, fieldName)); it != fields.end() && it->second.position <= limit) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+const StructDefinitionAST* SymbolTable::lookupTemplate(const string& name, const uint32_t limit) const {
+    if (const auto it = structTemplates.find(name); it != structTemplates.end() && it->second.position <= limit) {
+        return it->second.ast;
+    }
+    return nullptr;
+}
+
+void SymbolTable::noteInstantiation(const TypeAST& type) const {
+    if (globals) {
+        globals->noteInstantiation(type);
+        return;
+    }
+    if (usedInstantiations) {
+        lock_guard lock(usedInstantiations->mutex);
+        if (usedInstantiations->seen.insert(type.id()).second) {
+            usedInstantiations->types.insert(type.source());
+        }
+    }
+}
+
+bool SymbolTable::requestInstantiation(TypeAST& type) const {
+    if (!requests) return false;
+    requests->push(task, &type);
+    return true;
+}
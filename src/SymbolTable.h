@@ -5,46 +5,134 @@
 #ifndef SYMBOLTABLE_H
 #define SYMBOLTABLE_H
 #include <map>
+#include <mutex>
 #include <optional>
-#include <ranges>
 #include <set>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "AST.h"
+#include "NameTable.h"
+#include "SymbolInfo.h"
+#include "TypeTable.h"
 class StructDefinitionAST;
 class BlockAST;
 class AST;
+class InstantiationQueue;
 
 using namespace std;
 
 
-struct SymbolInfo {
-    enum SymbolType {
-        Function, Structure, Variable, Generic, Type
-    };
-    std::string type;
-    SymbolType metaType;
-    bool isStatic;
-    bool constant;
-};
 
-// Map: struct_name -> { field_name -> SymbolInfo }
-using StructFieldMap = std::map<std::string, SymbolInfo>;
+// Fields of a structure being registered
+using StructFieldMap = std::vector<std::pair<NameId, SymbolInfo>>;
 
+/**
+ * @brief Scoped symbols, keyed by interned names
+ *
+ * Every binding lives in a single stack. 'visible' maps each name to its innermost binding,
+ * which links to the binding it shadows : a lookup is one array access, entering a scope pushes
+ * a mark and leaving it pops the bindings above the mark, restoring what they shadowed.
+ *
+ * A local table only holds the scopes of one function body, everything else is read from the
+ * global table it was created over (see analyseParallel). It only sees what the global table
+ * declared up to its position, as the body would have when analysed in source order.
+ */
 class SymbolTable {
-    std::vector<std::map<std::string, SymbolInfo>> scopes;
-    std::map<std::string, StructFieldMap> knownStructs;
+    static constexpr uint32_t NoBinding = UINT32_MAX;
+    static constexpr uint32_t AllPositions = UINT32_MAX; // Limit of the lookups of a global table
+
+    const SymbolTable* globals = nullptr;    // Set for a local table
+    InstantiationQueue* requests = nullptr;  // Instantiations requested by a local table
+    size_t task = 0;                         // Index of the body of a local table in its queue
+
+    struct Binding {
+        NameId name;
+        SymbolInfo info;
+        uint32_t shadowed; // Previous binding of the same name
+    };
+
+    std::vector<Binding> bindings;
+    std::vector<uint32_t> visible;     // Indexed by NameId
+    std::vector<uint32_t> scopeStarts; // First binding of each scope
+
+    // Fields of every known structure, keyed by (structure, field)
+    std::unordered_set<NameId> knownStructs;
+    std::unordered_map<uint64_t, SymbolInfo> fields;
+
+    // Callables grouped by (owner, name) then by arity : free functions have no owner,
+    // methods are owned by their structure and constructors are the unnamed callables of their structure
+    std::unordered_map<uint64_t, std::vector<std::vector<Overload>>> overloads;
+
+    struct Template {
+        const StructDefinitionAST* ast;
+        uint32_t position;
+    };
+    std::map<std::string, Template> structTemplates;
+
+    // Instantiated structures keyed by (template, argument types). A lookup hashes the arguments of
+    // a TypeAST in place (their ids are cached), without building a key
+    struct InstantiationKey {
+        const StructDefinitionAST* genericTemplate;
+        std::vector<TypeId> args;
+    };
+    struct InstantiationArgs {
+        const StructDefinitionAST* genericTemplate;
+        const std::vector<unique_ptr<TypeAST>>& args;
+    };
+    struct InstantiationHash {
+        using is_transparent = void;
+        size_t operator()(const InstantiationKey& key) const noexcept;
+        size_t operator()(const InstantiationArgs& key) const noexcept;
+    };
+    struct InstantiationEqual {
+        using is_transparent = void;
+        bool operator()(const InstantiationKey& a, const InstantiationKey& b) const noexcept;
+        bool operator()(const InstantiationArgs& a, const InstantiationKey& b) const noexcept;
+        bool operator()(const InstantiationKey& a, const InstantiationArgs& b) const noexcept { return (*this)(b, a); }
+    };
+    std::unordered_map<InstantiationKey, const StructDefinitionAST*, InstantiationHash, InstantiationEqual> instantiations;
 
-    std::map<std::string, const StructDefinitionAST*> structTemplates;
-    set<string> instantiations;
+    static uint64_t fieldKey(const NameId structName, const NameId fieldName) {
+        return static_cast<uint64_t>(structName.index()) << 32 | fieldName.index();
+    }
+
+    static uint64_t overloadKey(const TypeId owner, const NameId name) {
+        return static_cast<uint64_t>(owner.index()) << 32 | name.index();
+    }
+
+    // Lookups of a global table for a local one at 'limit' : what was declared after is hidden
+    std::optional<SymbolInfo> lookupSymbol(NameId name, uint32_t limit) const;
+    std::optional<SymbolInfo> lookupField(NameId structName, NameId fieldName, uint32_t limit) const;
+    const Overload* resolve(TypeId owner, NameId name, std::span<const TypeId> args, uint32_t limit) const;
+    const StructDefinitionAST* lookupTemplate(const string& name, uint32_t limit) const;
 
 public:
+    // Generic types used by the analysis, as written in the source (see BuildState)
+    struct InstantiationLog {
+        std::mutex mutex;
+        std::set<std::string> types;
+        std::unordered_set<TypeId> seen; // Each type is written out once, not at every use
+
+        void clear() {
+            types.clear();
+            seen.clear();
+        }
+    };
+
     unique_ptr<BlockAST> generics; // Block holding the monomorphs structure
+    InstantiationLog* usedInstantiations = nullptr; // Filled by the global table, when set
+    // Top-level statements analysed so far : a global table stamps it on what it declares, a local table
+    // sees what was stamped up to its own. Declarations stamped 0 are visible everywhere
+    uint32_t position = 0;
 
     SymbolTable() : generics(make_unique<BlockAST>()) {
         enterScope();
-        addSymbol("int", {"int", SymbolInfo::Type});
+        TypeTable& types = TypeTable::Global();
+        addSymbol("int", {TypeTable::Int, SymbolInfo::Type});
         // TODO : more types
         /*addSymbol("uint", {"unsigned int", SymbolInfo::Type});
         addSymbol("int8", {"char", SymbolInfo::Type});
@@ -56,103 +144,114 @@ public:
         addSymbol("int64", {"long", SymbolInfo::Type});
         addSymbol("uint64", {"unsigned long", SymbolInfo::Type});*/
 
-        addSymbol("float", {"float", SymbolInfo::Type});
-        addSymbol("double", {"double", SymbolInfo::Type});
+        addSymbol("float", {TypeTable::Float, SymbolInfo::Type});
+        addSymbol("double", {types.intern("double"), SymbolInfo::Type});
         //addSymbol("ldouble", {"long double", SymbolInfo::Type});
 
-        addSymbol("char", {"char", SymbolInfo::Type});
+        addSymbol("char", {types.intern("char"), SymbolInfo::Type});
         //addSymbol("uchar", {"unsigned char", SymbolInfo::Type});
     }
 
-    void enterScope() {
-        scopes.emplace_back();
+    // Local table of a body analysed concurrently : 'globals' must not change while it is used
+    SymbolTable(const SymbolTable& globals, InstantiationQueue& requests, const size_t task, const uint32_t position)
+        : globals(&globals), requests(&requests), task(task), position(position) {
+        enterScope();
     }
 
-    void exitScope() {
-        if (scopes.size() > 1) {
-            scopes.pop_back();
-        }
+    // Empties a local table for another body, keeping its allocations (the index by name is as large as the NameTable)
+    void reset(const SymbolTable& newGlobals, InstantiationQueue& newRequests, size_t newTask, uint32_t newPosition);
+
+    void enterScope() {
+        scopeStarts.push_back(static_cast<uint32_t>(bindings.size()));
     }
 
-    bool addStruct(const std::string& structName, const StructFieldMap& fields) {
-        if (knownStructs.contains(structName)) {
-            return false; // Déjà définie
-        }
-        knownStructs[structName] = fields;
-        return true;
+    void exitScope();
+
+    bool addStruct(NameId structName, const StructFieldMap& structFields);
+
+    bool addStruct(const std::string& structName, const StructFieldMap& structFields) {
+        return addStruct(NameTable::Global().intern(structName), structFields);
     }
 
     bool addTemplate(const string& name, const StructDefinitionAST* ast) {
-        if (structTemplates.contains(name)) return false;
-        structTemplates[name] = ast;
-        return true;
+        return structTemplates.try_emplace(name, ast, position).second;
     }
 
-    const StructDefinitionAST* lookupTemplate(const string& name) {
-        if (const auto it = structTemplates.find(name); it != structTemplates.end()) {
-            return it->second;
-        }
-        return nullptr;
+    const StructDefinitionAST* lookupTemplate(const string& name) const {
+        return globals ? globals->lookupTemplate(name, position) : lookupTemplate(name, AllPositions);
     }
 
-    void addInstantiation(const string& name) {
-        instantiations.insert(name);
-    }
+    // Structure instantiated from 'genericTemplate' with the generic arguments of 'type', null if there is none yet
+    const StructDefinitionAST* lookupInstantiation(const StructDefinitionAST* genericTemplate, const TypeAST& type) const;
 
-    optional<string> findInstantiation(const string& name) {
-        if(const auto it = instantiations.find(name); it != instantiations.end()) {
-            return name;
-        }
-        return std::nullopt;
+    void addInstantiation(const StructDefinitionAST* genericTemplate, const TypeAST& type, const StructDefinitionAST* instance);
+
+    [[nodiscard]] size_t instantiationCount() const {
+        return globals ? globals->instantiationCount() : instantiations.size();
     }
 
+    // Records a generic type used by the analysis, a local table records it in its global table
+    void noteInstantiation(const TypeAST& type) const;
+
+    // Queues the instantiation of 'type' if this is a local table, returns false otherwise
+    bool requestInstantiation(TypeAST& type) const;
+
     void registerGeneric(unique_ptr<AST> ast) const;
 
-    std::optional<SymbolInfo> lookupField(const std::string& structName, const std::string& fieldName) {
-        if (const auto it = knownStructs.find(structName); it != knownStructs.end()) {
-            const auto& fields = it->second;
-            if (const auto field_it = fields.find(fieldName); field_it != fields.end()) {
-                return field_it->second;
-            }
-        }
-        return std::nullopt;
+    /**
+     * @brief Adds a callable to the overload set of (owner, name)
+     * @return false if an overload with the same parameter types exists
+     */
+    bool addOverload(TypeId owner, NameId name, Overload overload);
+
+    /**
+     * @brief Overload of (owner, name) taking exactly the types 'args'
+     * @return the overload, valid until the next addOverload, or nullptr
+     */
+    [[nodiscard]] const Overload* resolve(TypeId owner, NameId name, std::span<const TypeId> args) const;
+
+    std::optional<SymbolInfo> lookupField(const NameId structName, const NameId fieldName) const {
+        return globals ? globals->lookupField(structName, fieldName, position) : lookupField(structName, fieldName, AllPositions);
+    }
+
+    std::optional<SymbolInfo> lookupField(const std::string& structName, const std::string& fieldName) const {
+        const NameTable& names = NameTable::Global();
+        const auto structId = names.find(structName);
+        const auto fieldId = names.find(fieldName);
+        if (!structId || !fieldId) return std::nullopt;
+        return lookupField(*structId, *fieldId);
     }
 
     /**
      * @brief Adds a symbol to the table
      * @return true if success, else false
      */
+    bool addSymbol(NameId name, const SymbolInfo& info);
+
     bool addSymbol(const std::string& name, const SymbolInfo& info) {
-        /*if (global) {
-            if (scopes.empty()) return false;
-            auto& globalScope = scopes.front();
-            if (globalScope.contains(name) && globalScope.at(name).metaType == info.metaType) {
-                return false;
-            }
-            globalScope[name] = info;
-            return true;
-        }*/
-        if (scopes.empty()) return false;
-        // Can be added if the meta type is different
-        // ex : function named 'a' can be added even if there exists a variable 'a'
-        if (scopes.back().contains(name) && scopes.back()[name].metaType == info.metaType) {
-            return false;
-        }
-        scopes.back()[name] = info;
-        return true;
+        return addSymbol(NameTable::Global().intern(name), info);
     }
 
     /** Function looking up for a symbol in the current scope.
      * @param name name of the symbol
      * @return SymbolInfo if found, else, nullopt
      */
-    std::optional<SymbolInfo> lookupSymbol(const std::string& name) {
-        for (auto & scope : std::ranges::reverse_view(scopes)) {
-            if (auto symbol = scope.find(name); symbol != scope.end()) {
-                return symbol->second;
+    std::optional<SymbolInfo> lookupSymbol(const NameId name) const {
+        if (globals) {
+            // The bindings of the body itself are all visible
+            if (name.index() < visible.size()) {
+                if (const uint32_t binding = visible[name.index()]; binding != NoBinding) {
+                    return bindings[binding].info;
+                }
             }
+            return globals->lookupSymbol(name, position);
         }
-        return std::nullopt;
+        return lookupSymbol(name, AllPositions);
+    }
+
+    std::optional<SymbolInfo> lookupSymbol(const std::string& name) const {
+        const auto id = NameTable::Global().find(name);
+        return id ? lookupSymbol(*id) : std::nullopt;
     }
 };
 
@@ -0,0 +1,86 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back([this] { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+static thread_local bool workerThread = false;
+
+bool ThreadPool::isWorkerThread() {
+    return workerThread;
+}
+
+void ThreadPool::work() {
+    workerThread = true;
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return; // Stopping and nothing left to do
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(const size_t count, const std::function<void(size_t)>& body) {
+    std::atomic<size_t> next = 0;
+    const auto drain = [&] {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            body(i);
+        }
+    };
+    std::vector<std::future<void>> helpers;
+    const size_t helperCount = std::min(count, workers.size() + 1) - (count > 0);
+    helpers.reserve(helperCount);
+    for (size_t i = 0; i < helperCount; i++) {
+        helpers.push_back(submit(drain));
+    }
+    // The helpers reference this frame : wait for all of them before reporting a failure
+    std::exception_ptr failure;
+    try {
+        drain();
+    } catch (...) {
+        failure = std::current_exception();
+        next = count;
+    }
+    for (auto& helper : helpers) {
+        try {
+            helper.get();
+        } catch (...) {
+            if (!failure) failure = std::current_exception();
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
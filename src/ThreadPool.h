@@ -0,0 +1,63 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads executing submitted tasks
+ *
+ * Tasks are run in submission order by the first idle worker.
+ * The destructor waits for the queued tasks to finish.
+ */
+class ThreadPool {
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping = false;
+
+    void work();
+
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]] size_t size() const { return workers.size(); }
+
+    // True on the worker threads of any pool : a task waiting for other tasks of its pool could wait forever
+    static bool isWorkerThread();
+
+    // Runs body(i) for every i in [0, count) on the workers and the calling thread, then returns.
+    // Indices are claimed one at a time, so a long body does not hold back the remaining ones
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    template <typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<F>> {
+        using Result = std::invoke_result_t<F>;
+        // std::function needs a copyable callable, the packaged task is shared
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard lock(mutex);
+            tasks.emplace([packaged] { (*packaged)(); });
+        }
+        available.notify_one();
+        return result;
+    }
+};
+
+#endif //THREADPOOL_H
@@ -0,0 +1,58 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "TokenStream.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "Logger.h"
+
+TokenStream::TokenStream(Lexer& lexer) : lexer(&lexer) {
+    fill(0);
+}
+
+TokenStream::TokenStream(std::vector<Token> tokens) : tokens(std::move(tokens)) {
+    if (this->tokens.empty()) {
+        this->tokens.push_back({TokenType::T_EOF, "EOF", 1, 1});
+    }
+}
+
+// Pulls tokens from the lexer until 'index' is in the ring
+void TokenStream::fill(const size_t index) {
+    while (pulled <= index) {
+        Token& slot = ring[pulled & (RingSize - 1)];
+        if (lexer->isFinished()) {
+            slot = ring[(pulled - 1) & (RingSize - 1)]; // Repeats the final T_EOF
+        } else {
+            slot = lexer->next();
+        }
+        pulled++;
+    }
+}
+
+const Token& TokenStream::at(const size_t index) {
+    if (lexer) {
+        fill(index);
+        return ring[index & (RingSize - 1)];
+    }
+    return tokens[std::min(index, tokens.size() - 1)];
+}
+
+const Token& TokenStream::peek(const size_t offset) {
+    if (offset > MaxLookahead) {
+        Logger::Error("Token lookahead out of bounds.");
+        throw SyntaxError();
+    }
+    return at(position + offset);
+}
+
+void TokenStream::advance() {
+    if (lexer) {
+        position++;
+        fill(position);
+    } else if (position + 1 < tokens.size()) {
+        position++; // Stay on the final T_EOF
+    }
+}
@@ -0,0 +1,52 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+#include <array>
+#include <vector>
+
+#include "Lexer.h"
+
+/**
+ * @brief Tokens consumed by the Parser
+ *
+ * Either pulls the tokens on demand from a Lexer, keeping only a small ring buffer
+ * of lookahead (streaming mode), or reads an already lexed vector (materialized mode).
+ * Once the end is reached, the stream stays on the T_EOF token.
+ */
+class TokenStream {
+public:
+    // Farthest token the Parser looks at, Parser::peek(2) when telling declarations from expressions
+    static constexpr size_t MaxLookahead = 2;
+
+private:
+    static constexpr size_t RingSize = 4; // Power of 2, holds the current token and the lookahead
+    static_assert(RingSize > MaxLookahead);
+
+    // Streaming mode
+    Lexer* lexer = nullptr;
+    std::array<Token, RingSize> ring{};
+    size_t pulled = 0; // Number of tokens pulled from the lexer so far
+
+    // Materialized mode
+    std::vector<Token> tokens;
+
+    size_t position = 0; // Index of the current token
+
+    void fill(size_t index);
+    const Token& at(size_t index);
+
+public:
+    explicit TokenStream(Lexer& lexer);
+    explicit TokenStream(std::vector<Token> tokens);
+
+    [[nodiscard]] const Token& current() const {
+        return lexer ? ring[position & (RingSize - 1)] : tokens[position];
+    }
+    const Token& peek(size_t offset);
+    void advance();
+};
+
+#endif //TOKENSTREAM_H
@@ -0,0 +1,187 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef TOKENTABLE_H
+#define TOKENTABLE_H
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "Lexer.h"
+
+enum class Associativity { Left, Right };
+
+struct TokenInfo {
+    TokenType type;
+    std::string_view spelling;
+    bool keyword;
+    int precedence; // -1 if the token is not a binary operator
+    Associativity associativity;
+};
+
+constexpr size_t TokenTypeCount = static_cast<size_t>(TokenType::T_Error) + 1;
+
+namespace detail {
+    constexpr TokenInfo tok(const TokenType type, const std::string_view spelling) {
+        return {type, spelling, false, -1, Associativity::Left};
+    }
+    constexpr TokenInfo keyword(const TokenType type, const std::string_view spelling) {
+        return {type, spelling, true, -1, Associativity::Left};
+    }
+    constexpr TokenInfo binary(const TokenType type, const std::string_view spelling, const int precedence,
+                               const Associativity assoc = Associativity::Left) {
+        return {type, spelling, false, precedence, assoc};
+    }
+}
+
+/**
+ * @brief Metadata of every token, indexed by TokenType
+ *
+ * Single source of truth for the spelling (tokenToString), the keywords (Lexer)
+ * and the binary operators precedence (Parser::parseOpRHS).
+ * Unary operators are handled in Parser::parsePrimary, they have no precedence here.
+ */
+inline constexpr std::array<TokenInfo, TokenTypeCount> tokenTable = {{
+    detail::tok(TokenType::T_ID, "ID"),
+    detail::tok(TokenType::T_Comma, ","),
+    detail::tok(TokenType::T_Semicolon, ";"),
+    detail::tok(TokenType::T_Dot, "."),
+    detail::tok(TokenType::T_StaticCall, "::"),
+    detail::tok(TokenType::T_LParen, "("),
+    detail::tok(TokenType::T_RParen, ")"),
+    detail::tok(TokenType::T_LBrace, "{"),
+    detail::tok(TokenType::T_RBrace, "}"),
+    detail::tok(TokenType::T_LBracket, "["),
+    detail::tok(TokenType::T_RBracket, "]"),
+    // Types
+    detail::tok(TokenType::T_Type, "Type"),
+    detail::tok(TokenType::T_Int, "Int"),
+    detail::tok(TokenType::T_Float, "Float"),
+    detail::tok(TokenType::T_Bool, "Bool"),
+    detail::keyword(TokenType::T_Struct, "struct"),
+    detail::keyword(TokenType::T_Constructor, "constructor"),
+    detail::tok(TokenType::T_String, "String"),
+    detail::tok(TokenType::T_Char, "Char"),
+    // Keywords
+    detail::keyword(TokenType::T_Extern, "extern"),
+    detail::keyword(TokenType::T_Extends, "extends"),
+    detail::keyword(TokenType::T_Return, "return"),
+    detail::keyword(TokenType::T_For, "for"),
+    detail::keyword(TokenType::T_While, "while"),
+    detail::keyword(TokenType::T_Continue, "continue"),
+    detail::keyword(TokenType::T_Break, "break"),
+    detail::keyword(TokenType::T_If, "if"),
+    detail::keyword(TokenType::T_Else, "else"),
+    detail::keyword(TokenType::T_Static, "static"),
+    // Operators
+    detail::binary(TokenType::T_Assign, "=", 5, Associativity::Right),
+    detail::tok(TokenType::T_Increment, "++"),
+    detail::tok(TokenType::T_Decrement, "--"),
+    detail::binary(TokenType::T_AddAssign, "+=", 5, Associativity::Right),
+    detail::binary(TokenType::T_SubAssign, "-=", 5, Associativity::Right),
+    detail::binary(TokenType::T_MulAssign, "*=", 5, Associativity::Right),
+    detail::binary(TokenType::T_DivAssign, "/=", 5, Associativity::Right),
+    detail::binary(TokenType::T_ModAssign, "%=", 5, Associativity::Right),
+    detail::binary(TokenType::T_AndAssign, "&=", 5, Associativity::Right),
+    detail::binary(TokenType::T_XorAssign, "^=", 5, Associativity::Right),
+    detail::binary(TokenType::T_OrAssign, "|=", 5, Associativity::Right),
+    detail::binary(TokenType::T_LShiftAssign, "<<=", 5, Associativity::Right),
+    detail::binary(TokenType::T_RShiftAssign, ">>=", 5, Associativity::Right),
+    detail::binary(TokenType::T_Mul, "*", 90),
+    detail::binary(TokenType::T_Div, "/", 90),
+    detail::binary(TokenType::T_Mod, "%", 90),
+    detail::binary(TokenType::T_Add, "+", 80),
+    detail::binary(TokenType::T_Sub, "-", 80),
+    detail::tok(TokenType::T_Not, "!"),
+    detail::tok(TokenType::T_Complement, "~"),
+    detail::binary(TokenType::T_LBitShift, "<<", 70),
+    detail::binary(TokenType::T_RBitShift, ">>", 70),
+    detail::binary(TokenType::T_BitAND, "&", 40),
+    detail::binary(TokenType::T_BitOR, "|", 20),
+    detail::binary(TokenType::T_BitXOR, "^", 30),
+    detail::binary(TokenType::T_LogOR, "||", 10),
+    detail::binary(TokenType::T_LogAND, "&&", 15),
+    detail::binary(TokenType::T_GT, ">", 60),
+    detail::binary(TokenType::T_GE, ">=", 60),
+    detail::binary(TokenType::T_LT, "<", 60),
+    detail::binary(TokenType::T_LE, "<=", 60),
+    detail::binary(TokenType::T_Equals, "==", 50),
+    detail::binary(TokenType::T_NotEquals, "!=", 50),
+    // Misc
+    detail::tok(TokenType::T_EOF, "EOF"),
+    detail::tok(TokenType::T_Error, "ERROR"),
+}};
+
+constexpr bool isTableOrdered() {
+    for (size_t i = 0; i < tokenTable.size(); i++) {
+        if (static_cast<size_t>(tokenTable[i].type) != i) return false;
+    }
+    return true;
+}
+static_assert(isTableOrdered(), "tokenTable must follow the declaration order of TokenType.");
+
+constexpr const TokenInfo& tokenInfo(const TokenType type) {
+    return tokenTable[static_cast<size_t>(type)];
+}
+
+// --- Keywords perfect hash ---
+
+namespace detail {
+    constexpr size_t KeywordSlots = 32; // Power of 2
+
+    constexpr size_t keywordHash(const std::string_view word, const uint32_t seed) {
+        return (static_cast<uint8_t>(word.front()) * seed + static_cast<uint8_t>(word.back()) + word.size()) & (KeywordSlots - 1);
+    }
+
+    constexpr bool isPerfectSeed(const uint32_t seed) {
+        std::array<bool, KeywordSlots> used{};
+        for (const auto& info : tokenTable) {
+            if (!info.keyword) continue;
+            const size_t slot = keywordHash(info.spelling, seed);
+            if (used[slot]) return false;
+            used[slot] = true;
+        }
+        return true;
+    }
+
+    // Smallest seed giving no collision between the keywords
+    constexpr uint32_t findKeywordSeed() {
+        for (uint32_t seed = 1; seed < 1024; seed++) {
+            if (isPerfectSeed(seed)) return seed;
+        }
+        return 0;
+    }
+
+    constexpr uint32_t KeywordSeed = findKeywordSeed();
+    static_assert(KeywordSeed != 0, "No perfect hash found for the keywords, increase KeywordSlots.");
+
+    constexpr std::array<TokenType, KeywordSlots> buildKeywordSlots() {
+        std::array<TokenType, KeywordSlots> slots{};
+        slots.fill(TokenType::T_ID);
+        for (const auto& info : tokenTable) {
+            if (info.keyword) slots[keywordHash(info.spelling, KeywordSeed)] = info.type;
+        }
+        return slots;
+    }
+
+    inline constexpr std::array<TokenType, KeywordSlots> keywordSlots = buildKeywordSlots();
+}
+
+/**
+ * @brief Finds the keyword spelled by 'word' with a single probe
+ * @return The keyword token type, or T_ID if 'word' is an identifier
+ */
+constexpr TokenType lookupKeyword(const std::string_view word) {
+    if (word.empty()) return TokenType::T_ID;
+    const TokenType candidate = detail::keywordSlots[detail::keywordHash(word, detail::KeywordSeed)];
+    if (candidate != TokenType::T_ID && tokenInfo(candidate).spelling == word) {
+        return candidate;
+    }
+    return TokenType::T_ID;
+}
+
+static_assert(lookupKeyword("constructor") == TokenType::T_Constructor);
+static_assert(lookupKeyword("extend") == TokenType::T_ID);
+
+#endif //TOKENTABLE_H
@@ -0,0 +1,129 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "TypeTable.h"
+
+#include <mutex>
+
+#include "AST.h"
+
+const std::string& TypeId::name() const {
+    return TypeTable::Global().mangled(*this);
+}
+
+TypeTable& TypeTable::Global() {
+    static TypeTable table;
+    return table;
+}
+
+TypeTable::TypeTable() {
+    for (const std::string_view name : {"", "error_type", "int", "float", "string", "void", "generic"}) {
+        intern(name);
+    }
+}
+
+const TypeTable::Entry& TypeTable::entry(const TypeId type) const {
+    std::shared_lock lock(mutex);
+    return entries[type.index()];
+}
+
+size_t TypeTable::size() const {
+    std::shared_lock lock(mutex);
+    return entries.size();
+}
+
+size_t TypeTable::StructureHash::operator()(const Structure& key) const noexcept {
+    size_t hash = key.base.index();
+    for (const TypeId arg : key.args) {
+        hash = hash * 1099511628211u ^ arg.index();
+    }
+    return (hash * 1099511628211u ^ static_cast<uint32_t>(key.arraySize)) << 1 | key.pointer;
+}
+
+std::optional<TypeId> TypeTable::find(const Structure& structure) const {
+    std::shared_lock lock(mutex);
+    if (const auto it = byStructure.find(structure); it != byStructure.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+TypeId TypeTable::add(const Structure& structure, std::string mangled) {
+    std::unique_lock lock(mutex);
+    if (const auto it = byStructure.find(structure); it != byStructure.end()) {
+        return it->second;
+    }
+    // A plain name is kept, it is spelled as written in the generated code
+    const bool plain = structure.args.empty() && structure.arraySize == NotArray;
+    if (!plain && mangledNames.contains(mangled)) {
+        const std::string taken = std::move(mangled);
+        for (size_t suffix = 2; mangledNames.contains(mangled = taken + '_' + std::to_string(suffix)); suffix++) {}
+    }
+    const TypeId id(static_cast<uint32_t>(entries.size()));
+    const Entry& entry = entries.emplace_back(Entry{structure.base, {structure.args.begin(), structure.args.end()},
+                                                    structure.arraySize, structure.pointer, std::move(mangled)});
+    byStructure.emplace(Structure{entry.base, entry.args, entry.arraySize, entry.pointer}, id);
+    mangledNames.insert(entry.mangled);
+    return id;
+}
+
+TypeId TypeTable::intern(const std::string_view name) {
+    if (!name.empty() && name.back() == '*') {
+        return pointerTo(intern(name.substr(0, name.size() - 1)));
+    }
+    const Structure structure{NameTable::Global().intern(name), {}, NotArray, false};
+    if (const auto id = find(structure)) {
+        return *id;
+    }
+    return add(structure, std::string(name));
+}
+
+TypeId TypeTable::intern(const std::string_view base, const std::span<const TypeId> args, const int arraySize) {
+    if (args.empty() && arraySize == NotArray) {
+        return intern(base);
+    }
+    const Structure structure{NameTable::Global().intern(base), args, arraySize, false};
+    if (const auto id = find(structure)) {
+        return *id;
+    }
+    std::string mangled(base);
+    for (const TypeId arg : args) {
+        mangled += '_';
+        mangled += entry(arg).mangled;
+    }
+    if (arraySize != NotArray) {
+        mangled += "_array";
+        if (arraySize != UnsizedArray) mangled += std::to_string(arraySize);
+    }
+    return add(structure, std::move(mangled));
+}
+
+TypeId TypeTable::intern(const TypeAST& type) {
+    std::vector<TypeId> args;
+    args.reserve(type.genericArgs.size());
+    for (const auto& arg : type.genericArgs) {
+        args.push_back(arg->id());
+    }
+    int arraySize = NotArray;
+    if (type.isArray || type.arraySize) {
+        const auto size = ast_cast<IntExprAST>(type.arraySize.get());
+        arraySize = size ? size->value() : UnsizedArray;
+    }
+    return intern(type.type, args, arraySize);
+}
+
+TypeId TypeTable::pointerTo(const TypeId type) {
+    const Entry& pointee = entry(type);
+    const TypeId args[] = {type};
+    const Structure structure{pointee.base, args, NotArray, true};
+    if (const auto id = find(structure)) {
+        return *id;
+    }
+    return add(structure, pointee.mangled + '*');
+}
+
+TypeId TypeTable::pointee(const TypeId type) const {
+    const Entry& pointer = entry(type);
+    return pointer.pointer ? pointer.args.front() : type;
+}
@@ -0,0 +1,124 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef TYPETABLE_H
+#define TYPETABLE_H
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "NameTable.h"
+
+class TypeAST;
+
+/**
+ * @brief Identifier of an interned type : two types are the same if and only if their ids are equal
+ */
+class TypeId {
+    uint32_t value = 0;
+public:
+    constexpr TypeId() = default;
+    constexpr explicit TypeId(const uint32_t value) : value(value) {}
+
+    [[nodiscard]] constexpr uint32_t index() const { return value; }
+    constexpr bool operator==(const TypeId&) const = default;
+
+    // Mangled name, as it appears in the generated C code and in the signatures
+    [[nodiscard]] const std::string& name() const;
+};
+
+template <>
+struct std::hash<TypeId> {
+    size_t operator()(const TypeId id) const noexcept { return id.index(); }
+};
+
+/**
+ * @brief Global interner of the types met during the analysis
+ *
+ * Each distinct type is stored once, keyed by its structure : base name, generic argument ids,
+ * array size and pointer flag. 'Pair<Pair<int, int>, int>' and 'Pair<Pair<int, int, int> >' are
+ * different types, as are a structure named 'List_int' and 'List<int>'.
+ * The mangled name is derived when a type is first interned : the base name followed by the
+ * mangled names of its arguments, with a numeric suffix when another type already has that name.
+ * Structures are interned by their pre-pass, before any generic type : a structure always keeps
+ * its own name and the instantiations take the suffixes.
+ * The table can be used from several threads : interning a new type takes an exclusive lock,
+ * everything else a shared one.
+ */
+class TypeTable {
+public:
+    static constexpr int NotArray = -1;
+    static constexpr int UnsizedArray = 0;
+
+    struct Entry {
+        NameId base;                // Name without generic arguments
+        std::vector<TypeId> args;   // Generic arguments, or the pointee for pointers
+        int arraySize = NotArray;
+        bool pointer = false;
+        std::string mangled;        // Unique among the interned types
+    };
+
+    // Predefined types, interned first in this order
+    static constexpr TypeId None {0};   // No type (void expressions, missing return)
+    static constexpr TypeId Error {1};
+    static constexpr TypeId Int {2};
+    static constexpr TypeId Float {3};
+    static constexpr TypeId String {4};
+    static constexpr TypeId Void {5};
+    static constexpr TypeId Generic {6};
+
+    static TypeTable& Global();
+
+    // Type spelled 'name' without generic arguments, "T*" is the pointer to T
+    TypeId intern(std::string_view name);
+    TypeId intern(std::string_view base, std::span<const TypeId> args, int arraySize = NotArray);
+    // Interns the type described by the tree, see TypeAST::id for the cached version
+    TypeId intern(const TypeAST& type);
+
+    TypeId pointerTo(TypeId type);
+    // Type pointed to, or the type itself if it is not a pointer
+    [[nodiscard]] TypeId pointee(TypeId type) const;
+
+    // Entries are never moved, the references stay valid
+    [[nodiscard]] const Entry& entry(TypeId type) const;
+    [[nodiscard]] const std::string& mangled(const TypeId type) const { return entry(type).mangled; }
+    [[nodiscard]] size_t size() const;
+
+private:
+    // Key of an entry, its arguments are viewed in the entry itself (or in the caller's span for a lookup)
+    struct Structure {
+        NameId base;
+        std::span<const TypeId> args;
+        int arraySize;
+        bool pointer;
+
+        bool operator==(const Structure& other) const {
+            return base == other.base && std::ranges::equal(args, other.args) && arraySize == other.arraySize && pointer == other.pointer;
+        }
+    };
+    struct StructureHash {
+        size_t operator()(const Structure& key) const noexcept;
+    };
+
+    std::deque<Entry> entries; // Stable addresses : names and arguments are handed out by reference
+    std::unordered_map<Structure, TypeId, StructureHash> byStructure;
+    std::unordered_set<std::string_view> mangledNames; // Views of the entries' names
+    mutable std::shared_mutex mutex;
+
+    TypeTable();
+    [[nodiscard]] std::optional<TypeId> find(const Structure& structure) const;
+    // Interns the type unless another thread added it first, its mangled name is made unique here
+    TypeId add(const Structure& structure, std::string mangled);
+};
+
+#endif //TYPETABLE_H
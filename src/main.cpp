@@ -7,10 +7,48 @@
 #include "Onyx.h"
 #include "Parser.h"
 
-int main() {
+// Optional numeric argument following a flag, 'fallback' if absent
+static size_t sizeArgument(const int argc, char* argv[], int& i, const size_t fallback) {
+    if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+        return std::stoul(argv[++i]);
+    }
+    return fallback;
+}
+
+int main(int argc, char* argv[]) {
+    std::string sourcefile = "./progtest.ox";
+    Onyx compiler;
 
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--parallel-analysis") {
+            compiler.parallelAnalysis = true;
+            continue;
+        }
+        if (arg == "--module-path" && i + 1 < argc) {
+            compiler.searchPaths.emplace_back(argv[++i]);
+            continue;
+        }
+        if (arg == "-j") {
+            compiler.jobs = sizeArgument(argc, argv, i, 0);
+            continue;
+        }
+        if (arg.starts_with("-j") && std::isdigit(static_cast<unsigned char>(arg[2]))) {
+            compiler.jobs = std::stoul(arg.substr(2));
+            continue;
+        }
+        if (arg == "--rebuild") {
+            compiler.incremental = false;
+            continue;
+        }
+        if (arg == "--time-passes") {
+            compiler.timePasses = true;
+            continue;
+        }
+        sourcefile = arg;
+    }
 
-    Onyx().Compile("./progtest.ox");
+    compiler.Compile(sourcefile);
 
     return 0;
 }
@@ -0,0 +1,615 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "Benchmark.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "AST.h"
+#include "ASTArena.h"
+#include "ASTSerializer.h"
+#include "FlatAST.h"
+#include "Lexer.h"
+#include "LexerScan.h"
+#include "Logger.h"
+#include "ModuleIndex.h"
+#include "Monomorphizer.h"
+#include "ParallelAnalysis.h"
+#include "ParallelLexer.h"
+#include "Parser.h"
+#include "SourceFile.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// Wall time of the best of 'runs' executions of 'body', in seconds
+template <typename F>
+static double bestTime(const int runs, F&& body) {
+    double best = 1e30;
+    for (int i = 0; i < runs; i++) {
+        const auto start = chrono::steady_clock::now();
+        body();
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        best = min(best, elapsed.count());
+    }
+    return best;
+}
+
+static bool sameTokens(const vector<Token>& a, const vector<Token>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].type != b[i].type || a[i].value != b[i].value || a[i].line != b[i].line || a[i].col != b[i].col) {
+            return false;
+        }
+    }
+    return true;
+}
+
+string Benchmark::GenerateSource(const size_t bytes) {
+    string source;
+    source.reserve(bytes + 512);
+    for (size_t i = 0; source.size() < bytes; i++) {
+        const string id = to_string(i);
+        source += "// Generated module part " + id + "\n";
+        source += "struct Point" + id + " {\n    int x;\n    float y;\n}\n\n";
+        source += "/* Adds the coordinates\n   of the point */\n";
+        source += "int compute_" + id + "(int value, float scale) {\n";
+        source += "    int result = value * 42 + " + id + ";\n";
+        source += "    float ratio = scale / 3.25;\n";
+        source += "    string label = \"point number " + id + "\";\n";
+        source += "    result = result - (value << 2) % 100;\n";
+        source += "    return result;\n}\n\n";
+    }
+    return source;
+}
+
+// Source where strings, comments and extern blocks span many lines, to stress chunk boundaries
+static string generateMultilineSource(const size_t bytes) {
+    string source;
+    source.reserve(bytes + 512);
+    for (size_t i = 0; source.size() < bytes; i++) {
+        const string id = to_string(i);
+        source += "string text" + id + " = \"first line\n  // not a comment\n  /* neither */ \n  extern { }\";\n";
+        source += "/* comment with \"quotes\n   and // slashes\n   int fake = 1;\n*/\n";
+        source += "extern {\n  int native_" + id + "(int a) {\n    return a; // \"\n  }\n}\n";
+        source += "int value" + id + " = " + id + " * 2; // trailing \" quote\n";
+    }
+    return source;
+}
+
+int Benchmark::LexerThroughput(const size_t megabytes) {
+    const string source = GenerateSource(megabytes * 1024 * 1024);
+    const double size = static_cast<double>(source.size()) / (1024.0 * 1024.0);
+    cout << "Lexer throughput on " << fixed << setprecision(1) << size << " MB of generated source" << endl;
+
+    const ScanBackend initial = scan::activeBackend();
+    vector<Token> reference;
+    int status = EXIT_SUCCESS;
+
+    for (const ScanBackend backend : {ScanBackend::Scalar, ScanBackend::SSE2, ScanBackend::AVX2}) {
+        if (!scan::setBackend(backend)) continue;
+        vector<Token> tokens;
+        const double seconds = bestTime(3, [&] {
+            Lexer lexer(source);
+            tokens = lexer.tokenize();
+        });
+        cout << "  " << left << setw(8) << scan::backendName(backend) << right
+             << setw(10) << setprecision(1) << size / seconds << " MB/s  ("
+             << tokens.size() << " tokens)" << (backend == scan::defaultBackend() ? "  default" : "") << endl;
+
+        // Every backend must produce the exact same token stream
+        if (reference.empty()) {
+            reference = move(tokens);
+        } else if (!sameTokens(reference, tokens)) {
+            cerr << "Error : " << scan::backendName(backend) << " token stream differs from the scalar one." << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    scan::setBackend(initial);
+    return status;
+}
+
+int Benchmark::ParallelLexer(const size_t megabytes) {
+    ThreadPool pool;
+    int status = EXIT_SUCCESS;
+    cout << "Parallel lexer on " << pool.size() << " threads" << endl;
+
+    const pair<const char*, string> inputs[] = {
+        {"generated", GenerateSource(megabytes * 1024 * 1024)},
+        {"multi-line", generateMultilineSource(megabytes * 1024 * 1024)},
+    };
+    for (const auto& [name, source] : inputs) {
+        vector<Token> serial, parallel, small;
+        const double serialTime = bestTime(3, [&] { serial = Lexer(source).tokenize(); });
+        const double parallelTime = bestTime(3, [&] { parallel = tokenizeParallel(source, pool); });
+        // Tiny chunks : almost every boundary falls inside a string, a comment or an extern block
+        small = tokenizeParallel(source, pool, 64);
+
+        cout << "  " << left << setw(11) << name << right << fixed << setprecision(1)
+             << " serial " << setw(7) << serialTime * 1000 << " ms, parallel " << setw(7) << parallelTime * 1000
+             << " ms (x" << setprecision(2) << serialTime / parallelTime << ")" << endl;
+        if (!sameTokens(serial, parallel) || !sameTokens(serial, small)) {
+            cerr << "Error : parallel token stream differs from Lexer::tokenize() on " << name << " source." << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    return status;
+}
+
+int Benchmark::ASTAllocation(const size_t megabytes) {
+    const string source = GenerateSource(megabytes * 1024 * 1024);
+    cout << "AST allocation on " << megabytes << " MB of generated source (parse, clone, substitute, teardown)" << endl;
+
+    string reference;
+    int status = EXIT_SUCCESS;
+    // Two rounds, only the second one is reported : the first one warms up the allocator and the page cache
+    for (int round = 0; round < 2; round++) {
+        for (const bool useArena : {false, true}) {
+            double parseTime, cloneTime, walkTime, freeTime;
+            size_t arenaBytes;
+            ASTArena::ResetCount();
+            {
+                const auto arena = useArena ? make_unique<ASTArena>() : nullptr;
+                const auto scope = arena ? make_unique<ASTArena::Scope>(*arena) : nullptr;
+                unique_ptr<BlockAST> ast;
+                unique_ptr<AST> copy;
+                parseTime = bestTime(1, [&] {
+                    Lexer lexer(source);
+                    Parser parser(lexer);
+                    ast = parser.parse();
+                });
+                // What each generic instantiation does : a deep copy, then a substitution walk over every node
+                cloneTime = bestTime(1, [&] { copy = ast->clone(); });
+                map<string, unique_ptr<TypeAST>> typeMap;
+                typeMap["T"] = make_unique<TypeAST>("int");
+                walkTime = bestTime(1, [&] { substitute_recursive(copy.get(), typeMap); });
+                if (round == 0) {
+                    if (reference.empty()) {
+                        reference = copy->code();
+                    } else if (copy->code() != reference) {
+                        cerr << "Error : the arena allocated AST differs from the heap allocated one." << endl;
+                        status = EXIT_FAILURE;
+                    }
+                }
+                arenaBytes = arena ? arena->bytesUsed() : 0;
+                freeTime = bestTime(1, [&] {
+                    ast.reset();
+                    copy.reset();
+                });
+            }
+            if (round == 0) continue;
+            const auto [heapNodes, arenaNodes, chunks] = ASTArena::Count();
+            cout << "  " << (useArena ? "arena" : "heap ") << fixed << setprecision(1)
+                 << "  malloc calls " << setw(9) << heapNodes + chunks
+                 << " (" << heapNodes << " nodes, " << chunks << " chunks for " << arenaNodes << " nodes, "
+                 << arenaBytes / 1024 << " KB)"
+                 << "  parse " << setw(7) << parseTime * 1000 << " ms, clone " << setw(7) << cloneTime * 1000
+                 << " ms, substitute " << setw(6) << walkTime * 1000
+                 << " ms, teardown " << setw(7) << freeTime * 1000 << " ms" << endl;
+        }
+    }
+    return status;
+}
+
+int Benchmark::FlatASTPasses(const size_t megabytes) {
+    const string source = GenerateSource(megabytes * 1024 * 1024);
+    ASTArena arena;
+    ASTArena::Scope scope(arena);
+    Lexer lexer(source);
+    Parser parser(lexer);
+    const auto ast = parser.parse();
+
+    unique_ptr<FlatAST> flat;
+    const double flattenTime = bestTime(1, [&] { flat = make_unique<FlatAST>(*ast); });
+    cout << "Flat AST on " << megabytes << " MB of generated source : " << flat->nodeCount() << " nodes, flattened in "
+         << fixed << setprecision(1) << flattenTime * 1000 << " ms" << endl;
+
+    int status = EXIT_SUCCESS;
+    const string reference = ast->code();
+    if (flat->toTree()->code() != reference) {
+        cerr << "Error : the flat AST does not convert back to the same tree." << endl;
+        status = EXIT_FAILURE;
+    }
+
+    const auto report = [](const char* pass, const double treeTime, const double flatTime) {
+        cout << "  " << left << setw(11) << pass << right << " tree " << setw(7) << treeTime * 1000
+             << " ms, flat " << setw(7) << flatTime * 1000 << " ms (x" << setprecision(2) << treeTime / flatTime
+             << ")" << setprecision(1) << endl;
+    };
+
+    // Hoisting, in fresh tables (a second run would only report redefinitions)
+    SymbolTable treeTable, flatTable;
+    const double treePrePass = bestTime(1, [&] { ast->prePass(treeTable); });
+    const double flatPrePass = bestTime(1, [&] { flat->prePass(flatTable); });
+    report("prePass", treePrePass, flatPrePass);
+    for (const auto& stmt : ast->statements) {
+        if (const auto function = ast_cast<FunctionDefinitionAST>(stmt.get())) {
+            const Overload overload = function->overload();
+            const NameId name = NameTable::Global().intern(function->name);
+            const auto expected = treeTable.resolve(TypeTable::None, name, overload.params);
+            const auto found = flatTable.resolve(TypeTable::None, name, overload.params);
+            if (!found || found->symbol.type != expected->symbol.type || found->cName != expected->cName) {
+                cerr << "Error : flat prePass is missing '" << function->getSignature() << "'." << endl;
+                status = EXIT_FAILURE;
+                break;
+            }
+        }
+    }
+
+    // Substitution of every 'int' by a 'float', on copies
+    map<string, unique_ptr<TypeAST>> typeMap;
+    typeMap["int"] = make_unique<TypeAST>("float");
+    const auto tree = ast->clone();
+    const double treeSubstitute = bestTime(1, [&] { substitute_recursive(tree.get(), typeMap); });
+    const double flatSubstitute = bestTime(1, [&] { flat->substitute(typeMap); });
+    report("substitute", treeSubstitute, flatSubstitute);
+    if (flat->toTree()->code() != tree->code()) {
+        cerr << "Error : flat substitute differs from substitute_recursive." << endl;
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
+
+// Overloaded functions 'f0'..'f63', then callers holding 'calls' call sites spread over all the overloads
+static string generateCallSites(const size_t calls) {
+    constexpr size_t functions = 64;
+    constexpr size_t callsPerCaller = 100;
+    string source;
+    for (size_t i = 0; i < functions; i++) {
+        const string id = to_string(i);
+        source += "int f" + id + "(int a, int b) = a + b;\n";
+        source += "float f" + id + "(float a, float b) = a + b;\n";
+        source += "int f" + id + "(int a) = a;\n";
+    }
+    for (size_t caller = 0; caller * callsPerCaller < calls; caller++) {
+        source += "int caller" + to_string(caller) + "(int a, float b) {\n";
+        for (size_t k = 0; k < callsPerCaller && caller * callsPerCaller + k < calls; k++) {
+            const string function = "f" + to_string((caller * callsPerCaller + k) % functions);
+            const string result = "r" + to_string(k);
+            switch (k % 3) {
+                case 0: source += "    int " + result + " = " + function + "(a, a);\n"; break;
+                case 1: source += "    float " + result + " = " + function + "(b, b);\n"; break;
+                default: source += "    int " + result + " = " + function + "(a);\n"; break;
+            }
+        }
+        source += "    return a;\n}\n";
+    }
+    return source;
+}
+
+int Benchmark::OverloadResolution(const size_t calls) {
+    const string source = generateCallSites(calls);
+    ASTArena arena;
+    ASTArena::Scope scope(arena);
+    cout << "Overload resolution on " << calls << " call sites" << endl;
+
+    // Whole analysis, on a fresh tree every run : the calls keep their binding once resolved
+    vector<FunctionCallAST*> sites;
+    const double analyseTime = bestTime(3, [&] {
+        Lexer lexer(source);
+        Parser parser(lexer);
+        const auto ast = parser.parse();
+        SymbolTable table;
+        ast->prePass(table);
+        ast->analyse(table);
+        sites.clear();
+        for (const auto& stmt : ast->statements) {
+            const auto function = ast_cast<FunctionDefinitionAST>(stmt.get());
+            const auto body = function ? ast_cast<BlockAST>(function->body.get()) : nullptr;
+            if (!body) continue;
+            for (const auto& bodyStmt : body->statements) {
+                if (const auto declaration = ast_cast<VariableDeclarationAST>(bodyStmt.get())) {
+                    if (auto call = ast_cast<FunctionCallAST>(declaration->initializer.get()); call && call->binding) {
+                        sites.push_back(call);
+                    }
+                }
+            }
+        }
+    });
+    if (sites.size() != calls) {
+        cerr << "Error : " << calls - sites.size() << " call sites were not resolved." << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "  prePass + analyse " << fixed << setprecision(1) << setw(8) << analyseTime * 1000 << " ms" << endl;
+
+    // Resolution alone : the call sites again, with their argument types known
+    Lexer lexer(source);
+    Parser parser(lexer);
+    const auto ast = parser.parse();
+    SymbolTable overloads, signatures;
+    ast->prePass(overloads);
+    vector<pair<string, vector<TypeId>>> queries;
+    for (const auto& stmt : ast->statements) {
+        if (const auto function = ast_cast<FunctionDefinitionAST>(stmt.get()); function && function->name[0] == 'f') {
+            const Overload overload = function->overload();
+            signatures.addSymbol(overload.cName, overload.symbol);
+            queries.emplace_back(function->name, overload.params);
+        }
+    }
+
+    size_t found = 0;
+    const double signatureTime = bestTime(3, [&] {
+        found = 0;
+        for (size_t i = 0; i < calls; i++) {
+            const auto& [name, args] = queries[i % queries.size()];
+            string signature = "fun_" + name;
+            for (const TypeId arg : args) {
+                signature += '_' + arg.name();
+            }
+            found += signatures.lookupSymbol(signature).has_value();
+        }
+    });
+    const bool signaturesFound = found == calls;
+    const double overloadTime = bestTime(3, [&] {
+        found = 0;
+        for (size_t i = 0; i < calls; i++) {
+            const auto& [name, args] = queries[i % queries.size()];
+            const auto id = NameTable::Global().find(name);
+            found += id && overloads.resolve(TypeTable::None, *id, args);
+        }
+    });
+    if (!signaturesFound || found != calls) {
+        cerr << "Error : a call site was not resolved." << endl;
+        return EXIT_FAILURE;
+    }
+    const auto perCall = [calls](const double seconds) { return seconds * 1e9 / static_cast<double>(calls); };
+    cout << "  signature strings " << setw(8) << perCall(signatureTime) << " ns/call" << endl;
+    cout << "  overload sets     " << setw(8) << perCall(overloadTime) << " ns/call (x"
+         << setprecision(2) << signatureTime / overloadTime << ")" << endl;
+    return EXIT_SUCCESS;
+}
+
+// Structures, and functions taking one of them wrapped in a generic one (a new instantiation every 8 functions).
+// The first function uses a template, a field and a global declared after it : both analyses must reject them
+static string generateGenericSource(const size_t bytes) {
+    string source = "struct Box<T> {\n    T val;\n}\n\n"
+                    "int early(Late late) {\n    Later<int> later;\n    return late.x + counter;\n}\n\n"
+                    "int counter = 3;\n\nstruct Late {\n    int x;\n}\n\nstruct Later<T> {\n    T val;\n}\n\n";
+    source.reserve(bytes + 512);
+    for (size_t i = 0; source.size() < bytes; i++) {
+        const string id = to_string(i);
+        source += "struct Point" + id + " {\n    int x;\n    float y;\n}\n\n";
+        source += "int work_" + id + "(Box<Point" + to_string(i / 8) + "> box, int value, float scale) {\n";
+        source += "    int result = value * 42 + " + id + ";\n";
+        source += "    float ratio = scale / 3.25;\n";
+        source += "    result = result - (value << 2) % 100;\n";
+        source += "    return result;\n}\n\n";
+    }
+    return source;
+}
+
+int Benchmark::ParallelAnalysis(const size_t megabytes) {
+    const string source = generateGenericSource(megabytes * 1024 * 1024);
+    ThreadPool pool;
+    ASTArena arena;
+    ASTArena::Scope scope(arena);
+    cout << "Analysis of " << megabytes << " MB of generated source, function bodies on " << pool.size() << " threads" << endl;
+
+    vector<Logger::Message> reference;
+    size_t referenceInstantiations = 0;
+    double sequentialTime = 0;
+    int status = EXIT_SUCCESS;
+    for (const bool parallel : {false, true}) {
+        Lexer lexer(source);
+        Parser parser(lexer);
+        const auto ast = parser.parse();
+        SymbolTable table;
+        vector<Logger::Message> errors;
+        double analyseTime;
+        {
+            Logger::Capture capture(errors);
+            ast->prePass(table);
+            analyseTime = bestTime(1, [&] {
+                if (parallel) {
+                    analyseParallel(*ast, table, pool);
+                } else {
+                    ast->analyse(table);
+                }
+            });
+        }
+        const size_t instantiations = table.generics->statements.size();
+        cout << "  " << (parallel ? "parallel  " : "sequential") << fixed << setprecision(1) << setw(9)
+             << analyseTime * 1000 << " ms  (" << instantiations << " instantiations, " << errors.size() << " errors)";
+        if (!parallel) {
+            // 'Later', 'late.x' and 'counter' in 'early', then the sum of an unknown field
+            if (errors.size() != 4) {
+                cerr << "Error : " << errors.size() << " errors, 4 expected in 'early'." << endl;
+                status = EXIT_FAILURE;
+            }
+            reference = move(errors);
+            referenceInstantiations = instantiations;
+            sequentialTime = analyseTime;
+            cout << endl;
+            continue;
+        }
+        cout << "  x" << setprecision(2) << sequentialTime / analyseTime << endl;
+        if (errors != reference || instantiations != referenceInstantiations) {
+            cerr << "Error : the parallel analysis reports differ from the sequential one." << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    return status;
+}
+
+int Benchmark::ModuleResolution(const size_t files) {
+    // Generated tree : the modules, lost among other files in nested directories
+    const filesystem::path root = filesystem::temp_directory_path() / "onyx-bench-modules";
+    filesystem::remove_all(root);
+    constexpr size_t FilesPerDirectory = 50;
+    constexpr size_t ModuleEvery = 20;
+    vector<string> names;
+    for (size_t i = 0; i < files; i++) {
+        const filesystem::path directory = root / "src" / ("d" + to_string(i / FilesPerDirectory % 16)) / ("d" + to_string(i / FilesPerDirectory));
+        filesystem::create_directories(directory);
+        if (i % ModuleEvery == 0) {
+            names.push_back("module" + to_string(i));
+            ofstream(directory / (names.back() + ".ox")) << "int f" << i << "() = " << i << ";\n";
+        } else {
+            ofstream(directory / ("file" + to_string(i) + ".js"));
+        }
+    }
+    const vector<string> searchPaths = {(root / "src").string()};
+    const filesystem::path cacheFile = root / "build" / "modules.index";
+    cout << "Resolution of " << names.size() << " imports among " << files << " files" << endl;
+
+    size_t found = 0;
+    const double scanTime = bestTime(1, [&] {
+        for (const auto& name : names) {
+            for (const auto& entry : filesystem::recursive_directory_iterator(searchPaths.front())) {
+                if (entry.is_regular_file() && entry.path().filename() == name + ".ox") {
+                    found++;
+                    break;
+                }
+            }
+        }
+    });
+
+    int status = EXIT_SUCCESS;
+    const auto lookups = [&](const char* label, const bool expectCached) {
+        bool cached = false;
+        size_t resolved = 0;
+        const double time = bestTime(1, [&] {
+            const ModuleIndex index(searchPaths, cacheFile);
+            cached = index.cached();
+            for (const auto& name : names) {
+                resolved += index.find(name).has_value();
+            }
+        });
+        cout << "  " << label << fixed << setprecision(2) << setw(10) << time * 1000 << " ms  x"
+             << setprecision(1) << scanTime / time << endl;
+        if (resolved != names.size() || cached != expectCached) {
+            cerr << "Error : the module index did not resolve every import as expected." << endl;
+            status = EXIT_FAILURE;
+        }
+    };
+    cout << "  scan per import" << fixed << setprecision(2) << setw(10) << scanTime * 1000 << " ms" << endl;
+    lookups("index, walked  ", false);
+    lookups("index, cached  ", true);
+
+    // A new module invalidates the cache
+    ofstream(root / "src" / "d0" / "added.ox") << "int added() = 0;\n";
+    names.emplace_back("added");
+    lookups("index, rewalked", false);
+
+    filesystem::remove_all(root);
+    if (found + 1 != names.size()) {
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
+
+int Benchmark::ASTCache(const size_t megabytes) {
+    const filesystem::path directory = filesystem::temp_directory_path() / "onyx-bench-ast";
+    filesystem::create_directories(directory);
+    const filesystem::path sourcePath = directory / "module.ox";
+    const filesystem::path cachePath = directory / "module.ast";
+    ofstream(sourcePath, ios::binary) << GenerateSource(megabytes * 1024 * 1024);
+
+    ASTArena arena;
+    ASTArena::Scope scope(arena);
+    unique_ptr<BlockAST> parsed;
+    const double parseTime = bestTime(3, [&] {
+        const SourceFile source(sourcePath.string());
+        Lexer lexer(source.view());
+        Parser parser(lexer);
+        parsed = parser.parse();
+    });
+    string bytes;
+    const double saveTime = bestTime(3, [&] { bytes = serializeAST(*parsed); });
+    ofstream(cachePath, ios::binary) << bytes;
+    unique_ptr<BlockAST> loaded;
+    const double loadTime = bestTime(3, [&] {
+        const SourceFile cached(cachePath.string());
+        loaded = deserializeAST(cached.view());
+    });
+
+    cout << "AST cache on " << megabytes << " MB of generated source : " << bytes.size() / 1024 << " KB serialized" << endl
+         << fixed << setprecision(1) << "  parse " << setw(7) << parseTime * 1000 << " ms, load " << setw(7)
+         << loadTime * 1000 << " ms (x" << setprecision(2) << parseTime / loadTime << "), save " << setprecision(1)
+         << setw(7) << saveTime * 1000 << " ms" << endl;
+
+    // A loaded module is what clone() would copy of the parsed one, serialized back to the same bytes
+    int status = EXIT_SUCCESS;
+    if (!loaded || serializeAST(*loaded) != bytes || loaded->code() != parsed->code()) {
+        cerr << "Error : the loaded AST differs from the parsed one." << endl;
+        status = EXIT_FAILURE;
+    } else if (serializeAST(*cloneAs<BlockAST>(*parsed)) != bytes) {
+        cerr << "Error : the cloned AST does not serialize to the same bytes." << endl;
+        status = EXIT_FAILURE;
+    }
+    // Truncated files (a crash while writing) must be rejected, never half loaded
+    for (const size_t size : {size_t(0), size_t(4), bytes.size() / 2, bytes.size() - 1}) {
+        if (deserializeAST(string_view(bytes).substr(0, size))) {
+            cerr << "Error : a serialized AST truncated to " << size << " bytes was loaded." << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    filesystem::remove_all(directory);
+    return status;
+}
+
+int Benchmark::GenericInstantiation(const size_t functions) {
+    // Every function uses the same nested types, closed with '>>' as they are usually written
+    // 'Box_int' is a plain structure : it keeps its name, and 'Pair<Box_int, float>' and 'Pair<Box<int>, float>'
+    // are different types whose names would otherwise be the same
+    string source = "struct Box<T> {\n    T val;\n}\n\nstruct Pair<A, B> {\n    A first;\n    B second;\n}\n\n"
+                    "struct Box_int {\n    float val;\n}\n\n";
+    for (size_t i = 0; i < functions; i++) {
+        source += "int nested_" + to_string(i) + "(int value) {\n"
+                  "    Box<Box<int>> a;\n"
+                  "    Box<Box<float>> b;\n"
+                  "    Pair<Box<int>, Box<Box<float>>> c;\n"
+                  "    Box<Pair<int, float>> d;\n"
+                  "    Pair<Pair<int, float>, Box<Box<Box<int>>>> e;\n"
+                  "    Pair<Box_int, float> f;\n"
+                  "    Pair<Box<int>, float> g;\n"
+                  "    return value;\n}\n\n";
+    }
+    const set<string> expected = {"Box_int_2", "Box_float", "Box_Box_int_2", "Box_Box_float", "Box_Box_Box_int_2", "Pair_int_float",
+                                  "Box_Pair_int_float", "Pair_Box_int_2_Box_Box_float", "Pair_Pair_int_float_Box_Box_Box_int_2",
+                                  "Pair_Box_int_float", "Pair_Box_int_2_float"};
+
+    ASTArena arena;
+    ASTArena::Scope scope(arena);
+    Lexer lexer(source);
+    Parser parser(lexer);
+    const auto ast = parser.parse();
+    SymbolTable table;
+    vector<Logger::Message> errors;
+    double analyseTime;
+    {
+        Logger::Capture capture(errors);
+        ast->prePass(table);
+        analyseTime = bestTime(1, [&] { ast->analyse(table); });
+    }
+    cout << "Generic instantiation in " << functions << " functions (" << functions * 7 << " nested generic types) : "
+         << fixed << setprecision(1) << analyseTime * 1000 << " ms, " << table.instantiationCount() << " instantiations" << endl;
+
+    int status = EXIT_SUCCESS;
+    if (!errors.empty()) {
+        Logger::Flush(errors);
+        status = EXIT_FAILURE;
+    }
+    map<string, size_t> built;
+    for (const auto& statement : table.generics->statements) {
+        built[static_cast<const StructDefinitionAST*>(statement.get())->name]++;
+    }
+    for (const auto& [name, count] : built) {
+        if (count != 1 || !expected.contains(name)) {
+            cerr << "Error : '" << name << "' was instantiated " << count << " times." << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    if (built.size() != expected.size() || table.instantiationCount() != expected.size()) {
+        cerr << "Error : " << built.size() << " distinct instantiations, " << expected.size() << " expected." << endl;
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
@@ -0,0 +1,47 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+#include <string>
+
+/**
+ * Benchmarks of the compiler front end, run by the OnyxBench executable (see tests/main.cpp).
+ * Each one also checks its result against a reference implementation and returns the process
+ * exit code : non-zero if a check failed. ctest runs them all on small inputs.
+ */
+class Benchmark {
+public:
+    // Generates roughly 'bytes' of valid Onyx source (structs, functions, comments, literals)
+    static std::string GenerateSource(size_t bytes);
+
+    // Lexer throughput (MB/s) for every scanning backend supported by the CPU
+    static int LexerThroughput(size_t megabytes);
+
+    // Differential check and speedup of tokenizeParallel against Lexer::tokenize
+    static int ParallelLexer(size_t megabytes);
+
+    // AST node allocations and parse / clone / substitute / teardown time, with and without an ASTArena
+    static int ASTAllocation(size_t megabytes);
+
+    // prePass and substitute on the pointer tree against the same passes on a FlatAST
+    static int FlatASTPasses(size_t megabytes);
+
+    // Analysis time and call resolution through overload sets against the former signature strings
+    static int OverloadResolution(size_t calls);
+
+    // Differential check and speedup of analyseParallel against BlockAST::analyse
+    static int ParallelAnalysis(size_t megabytes);
+
+    // Module lookups through a ModuleIndex (walked, then cached) against a directory scan per import
+    static int ModuleResolution(size_t files);
+
+    // Round trip check and load time of a serialized AST (mapped file) against lexing and parsing the source
+    static int ASTCache(size_t megabytes);
+
+    // Nested generic types used by 'functions' functions : each distinct instantiation must be built exactly once
+    static int GenericInstantiation(size_t functions);
+};
+
+#endif //BENCHMARK_H
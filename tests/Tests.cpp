@@ -0,0 +1,291 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include "Tests.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <ranges>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "AST.h"
+#include "ASTArena.h"
+#include "ASTSerializer.h"
+#include "Lexer.h"
+#include "Logger.h"
+#include "Onyx.h"
+#include "Parser.h"
+
+using namespace std;
+
+// Empty project in a temporary directory, set up as a user does : the runtime and a builtins.h
+// including the generated instantiations, in its build directory
+static filesystem::path createProject(const string& name, const filesystem::path& runtime) {
+    const filesystem::path directory = filesystem::temp_directory_path() / ("onyx-test-" + name);
+    filesystem::remove_all(directory);
+    filesystem::create_directories(directory / "build");
+    for (const char* file : {"memory.c", "memory.h"}) {
+        filesystem::copy_file(runtime / file, directory / "build" / file);
+    }
+    ofstream(directory / "build" / "builtins.h") << "#include \"memory.h\"\n#include <stdio.h>\n#include \"generics.h\"\n";
+    return directory;
+}
+
+// Compiles 'mainModule' of the project in 'directory' and runs the executable, true if both succeed
+static bool compileAndRun(const filesystem::path& directory, const string& mainModule) {
+    const filesystem::path previous = filesystem::current_path();
+    filesystem::current_path(directory);
+    Onyx compiler;
+    const auto executable = compiler.Compile(mainModule + ".ox");
+    const bool success = executable && system(executable->c_str()) == 0;
+    filesystem::current_path(previous);
+    return success;
+}
+
+static string readFile(const filesystem::path& path) {
+    ifstream stream(path, ios::binary);
+    ostringstream content;
+    content << stream.rdbuf();
+    return content.str();
+}
+
+static size_t cachedObjects(const filesystem::path& directory) {
+    return ranges::count_if(filesystem::directory_iterator(directory / "build" / ".cache"),
+                            [](const filesystem::directory_entry& entry) { return entry.path().extension() == ".o"; });
+}
+
+int Tests::FreshBuild(const filesystem::path& runtime) {
+    const filesystem::path directory = createProject("fresh-build", filesystem::absolute(runtime));
+    ofstream(directory / "boxes.ox") << "struct Box<T> {\n    T val;\n}\n\nint boxed(int a) = a + 1;\n";
+    ofstream(directory / "main.ox") << "extern boxes;\n\nint main() {\n    Box<int> b;\n    int s = boxed(2);\n    return s - 3;\n}\n";
+
+    int status = EXIT_SUCCESS;
+    // Every module includes generics.h : it must be generated before the first of them is compiled
+    if (!compileAndRun(directory, "main")) {
+        cerr << "Error : the fresh build failed." << endl;
+        status = EXIT_FAILURE;
+    } else if (readFile(directory / "build" / "generics.h").find("} Box_int;") == string::npos) {
+        cerr << "Error : 'Box<int>' is not in generics.h." << endl;
+        status = EXIT_FAILURE;
+    }
+    // Objects of boxes, main, generics and the runtime
+    const size_t objects = cachedObjects(directory);
+    if (!compileAndRun(directory, "main") || cachedObjects(directory) != objects) {
+        cerr << "Error : the unchanged project was not rebuilt from the cache." << endl;
+        status = EXIT_FAILURE;
+    }
+
+    // A new instantiation changes generics.h : the unchanged boxes is compiled again against it
+    ofstream(directory / "main.ox") << "extern boxes;\n\nint main() {\n    Box<int> b;\n    Box<float> f;\n    int s = boxed(2);\n    return s - 3;\n}\n";
+    if (!compileAndRun(directory, "main")) {
+        cerr << "Error : the incremental build failed." << endl;
+        status = EXIT_FAILURE;
+    } else if (cachedObjects(directory) != objects + 3) {
+        cerr << "Error : " << cachedObjects(directory) - objects << " objects compiled after generics.h changed, 3 expected." << endl;
+        status = EXIT_FAILURE;
+    }
+    filesystem::remove_all(directory);
+    return status;
+}
+
+int Tests::NestedGenerics(const filesystem::path& runtime) {
+    const filesystem::path directory = createProject("nested-generics", filesystem::absolute(runtime));
+    ofstream(directory / "boxes.ox") << "struct Box<T> {\n    T val;\n}\n\nint boxed(int a) = a + 1;\n";
+    ofstream(directory / "main.ox") << "extern boxes;\n\nint main() {\n    Box<Box<int>> nested;\n    Box<Box<Box<int>>> deeper;\n"
+                                       "    int s = boxed(2);\n    return s - 3;\n}\n";
+
+    int status = EXIT_SUCCESS;
+    if (!compileAndRun(directory, "main")) {
+        cerr << "Error : the program using 'Box<Box<int>>' failed to build or run." << endl;
+        status = EXIT_FAILURE;
+    }
+    // Each instantiation is generated once, after the ones its fields use
+    const string generics = readFile(directory / "build" / "generics.h");
+    size_t previous = 0;
+    for (const string name : {"Box_int", "Box_Box_int", "Box_Box_Box_int"}) {
+        const size_t position = generics.find("} " + name + ";");
+        if (position == string::npos || position < previous || generics.find("} " + name + ";", position + 1) != string::npos) {
+            cerr << "Error : '" << name << "' is missing, duplicated or out of order in generics.h." << endl;
+            status = EXIT_FAILURE;
+        }
+        previous = position;
+    }
+    filesystem::remove_all(directory);
+    return status;
+}
+
+static bool sameAST(const AST* a, const AST* b, set<ASTKind>& kinds);
+
+template <typename Node>
+static bool sameList(const vector<unique_ptr<Node>>& a, const vector<unique_ptr<Node>>& b, set<ASTKind>& kinds) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!sameAST(a[i].get(), b[i].get(), kinds)) return false;
+    }
+    return true;
+}
+
+// Compares what the parser sets in both trees, written apart from the serializer so that a field
+// it forgets is caught. 'kinds' collects the kinds of the nodes met
+static bool sameAST(const AST* a, const AST* b, set<ASTKind>& kinds) {
+    if (!a || !b) return !a && !b;
+    if (a->kind != b->kind) return false;
+    kinds.insert(a->kind);
+    switch (a->kind) {
+        case ASTKind::Block:
+            return sameList(static_cast<const BlockAST*>(a)->statements, static_cast<const BlockAST*>(b)->statements, kinds);
+        case ASTKind::ExternStatement:
+            return static_cast<const ExternStatementAST*>(a)->libraryName == static_cast<const ExternStatementAST*>(b)->libraryName;
+        case ASTKind::Type: {
+            const auto* x = static_cast<const TypeAST*>(a);
+            const auto* y = static_cast<const TypeAST*>(b);
+            return x->type == y->type && x->isArray == y->isArray && sameList(x->genericArgs, y->genericArgs, kinds)
+                && sameAST(x->arraySize.get(), y->arraySize.get(), kinds);
+        }
+        case ASTKind::FunctionParameter: {
+            const auto* x = static_cast<const FunctionParameterAST*>(a);
+            const auto* y = static_cast<const FunctionParameterAST*>(b);
+            return x->name == y->name && sameAST(x->type.get(), y->type.get(), kinds);
+        }
+        case ASTKind::FunctionDefinition: {
+            const auto* x = static_cast<const FunctionDefinitionAST*>(a);
+            const auto* y = static_cast<const FunctionDefinitionAST*>(b);
+            return x->name == y->name && x->isStatic == y->isStatic && sameAST(x->returnType.get(), y->returnType.get(), kinds)
+                && sameList(x->params, y->params, kinds) && sameAST(x->body.get(), y->body.get(), kinds);
+        }
+        case ASTKind::VariableDeclaration: {
+            const auto* x = static_cast<const VariableDeclarationAST*>(a);
+            const auto* y = static_cast<const VariableDeclarationAST*>(b);
+            return x->name == y->name && sameAST(x->type.get(), y->type.get(), kinds)
+                && sameAST(x->initializer.get(), y->initializer.get(), kinds);
+        }
+        case ASTKind::GenericParameter:
+            return static_cast<const GenericParameterAST*>(a)->name == static_cast<const GenericParameterAST*>(b)->name;
+        case ASTKind::StructField: {
+            const auto* x = static_cast<const StructFieldAST*>(a);
+            const auto* y = static_cast<const StructFieldAST*>(b);
+            return x->name == y->name && sameAST(x->type.get(), y->type.get(), kinds);
+        }
+        case ASTKind::StructDefinition: {
+            const auto* x = static_cast<const StructDefinitionAST*>(a);
+            const auto* y = static_cast<const StructDefinitionAST*>(b);
+            return x->name == y->name && sameList(x->genericParams, y->genericParams, kinds) && sameList(x->fields, y->fields, kinds);
+        }
+        case ASTKind::ConstructorDefinition: {
+            const auto* x = static_cast<const ConstructorDefinitionAST*>(a);
+            const auto* y = static_cast<const ConstructorDefinitionAST*>(b);
+            return x->structName == y->structName && sameList(x->params, y->params, kinds) && sameAST(x->body.get(), y->body.get(), kinds);
+        }
+        case ASTKind::ExtendsStatement: {
+            const auto* x = static_cast<const ExtendsStatementAST*>(a);
+            const auto* y = static_cast<const ExtendsStatementAST*>(b);
+            return x->structName == y->structName && x->parentStructName == y->parentStructName && sameList(x->members, y->members, kinds);
+        }
+        case ASTKind::Return:
+            return sameAST(static_cast<const ReturnAST*>(a)->value.get(), static_cast<const ReturnAST*>(b)->value.get(), kinds);
+        case ASTKind::IfStatement: {
+            const auto* x = static_cast<const IfStatementAST*>(a);
+            const auto* y = static_cast<const IfStatementAST*>(b);
+            return sameAST(x->condition.get(), y->condition.get(), kinds) && sameAST(x->thenBody.get(), y->thenBody.get(), kinds)
+                && sameAST(x->elseBody.get(), y->elseBody.get(), kinds);
+        }
+        case ASTKind::FloatExpr:
+            return static_cast<const FloatExprAST*>(a)->value() == static_cast<const FloatExprAST*>(b)->value();
+        case ASTKind::IntExpr:
+            return static_cast<const IntExprAST*>(a)->value() == static_cast<const IntExprAST*>(b)->value();
+        case ASTKind::StringExpr:
+            return static_cast<const StringExprAST*>(a)->value() == static_cast<const StringExprAST*>(b)->value();
+        case ASTKind::VariableExpr:
+            return static_cast<const VariableExprAST*>(a)->name == static_cast<const VariableExprAST*>(b)->name;
+        case ASTKind::FieldAccess: {
+            const auto* x = static_cast<const FieldAccessAST*>(a);
+            const auto* y = static_cast<const FieldAccessAST*>(b);
+            return x->name == y->name && sameAST(x->ownerExpr.get(), y->ownerExpr.get(), kinds);
+        }
+        case ASTKind::OperationExpr: {
+            const auto* x = static_cast<const OperationExprAST*>(a);
+            const auto* y = static_cast<const OperationExprAST*>(b);
+            return x->op == y->op && sameAST(x->LHS.get(), y->LHS.get(), kinds) && sameAST(x->RHS.get(), y->RHS.get(), kinds);
+        }
+        case ASTKind::FunctionCall: {
+            const auto* x = static_cast<const FunctionCallAST*>(a);
+            const auto* y = static_cast<const FunctionCallAST*>(b);
+            return x->name == y->name && sameList(x->params, y->params, kinds);
+        }
+        case ASTKind::MethodCall: {
+            const auto* x = static_cast<const MethodCallAST*>(a);
+            const auto* y = static_cast<const MethodCallAST*>(b);
+            return x->name == y->name && sameAST(x->ownerExpr.get(), y->ownerExpr.get(), kinds) && sameList(x->params, y->params, kinds);
+        }
+        case ASTKind::VariableAssignment: {
+            const auto* x = static_cast<const VariableAssignmentAST*>(a);
+            const auto* y = static_cast<const VariableAssignmentAST*>(b);
+            return sameAST(x->target.get(), y->target.get(), kinds) && sameAST(x->value.get(), y->value.get(), kinds);
+        }
+        case ASTKind::ExternExpr:
+            return static_cast<const ExternExprAST*>(a)->body == static_cast<const ExternExprAST*>(b)->body;
+    }
+    return false;
+}
+
+int Tests::ASTRoundTrip() {
+    static const string source =
+        "extern other;\n\n"
+        "struct Point {\n    int x;\n    float y;\n}\n\n"
+        "struct Pair<A, B> {\n    A first;\n    Box<B> second;\n}\n\n"
+        "extends Point {\n    int z;\n    constructor(int x) {\n        return x;\n    };\n    int length() {\n        return x + y;\n    }\n}\n\n"
+        "Point3 extends Point {\n    float w;\n}\n\n"
+        "static int count(int a) = a + 1;\n\n"
+        "int main(int argc, string name) {\n"
+        "    Point p = Point(1);\n"
+        "    Pair<Box<int>, float> pair;\n"
+        "    float ratio = 3.25;\n"
+        "    string label = \"a label\";\n"
+        "    int sum = p.x * -2 - (argc << 1) % 7;\n"
+        "    sum = p.length() + count(sum);\n"
+        "    if (sum > 0) {\n        return sum;\n    } else {\n        return 0;\n    };\n"
+        "    extern {\n        printf(\"%d\\n\", sum);\n    }\n"
+        "    return sum;\n"
+        "}\n";
+
+    ASTArena arena;
+    ASTArena::Scope scope(arena);
+    vector<Logger::Message> messages;
+    unique_ptr<BlockAST> parsed;
+    try {
+        Logger::Capture capture(messages);
+        Lexer lexer(source);
+        Parser parser(lexer);
+        parsed = parser.parse();
+    } catch (const SyntaxError&) {}
+    Logger::Flush(messages);
+    if (!parsed || !messages.empty()) {
+        cerr << "Error : the sample does not parse." << endl;
+        return EXIT_FAILURE;
+    }
+    int status = EXIT_SUCCESS;
+
+    const string bytes = serializeAST(*parsed);
+    const auto loaded = deserializeAST(bytes);
+    set<ASTKind> kinds;
+    if (!loaded || !sameAST(parsed.get(), loaded.get(), kinds)) {
+        cerr << "Error : the deserialized AST differs from the parsed one." << endl;
+        return EXIT_FAILURE;
+    }
+    if (serializeAST(*loaded) != bytes) {
+        cerr << "Error : the deserialized AST does not serialize to the same bytes." << endl;
+        status = EXIT_FAILURE;
+    }
+    // The sample must keep covering the format as nodes are added
+    for (uint8_t kind = 0; kind <= static_cast<uint8_t>(ASTKind::ExternExpr); kind++) {
+        if (!kinds.contains(static_cast<ASTKind>(kind))) {
+            cerr << "Error : the sample has no node of kind " << static_cast<int>(kind) << "." << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,26 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#ifndef TESTS_H
+#define TESTS_H
+#include <filesystem>
+
+/**
+ * End to end checks of the compiler, run by the OnyxTests executable (see tests/TestsMain.cpp).
+ * Each one returns the process exit code : non-zero if a check failed.
+ * The compiling ones need clang and the runtime sources ('runtime' holds memory.c and memory.h).
+ */
+class Tests {
+public:
+    // Two modules sharing a generic type, compiled from an empty build directory then again incrementally
+    static int FreshBuild(const std::filesystem::path& runtime);
+
+    // Nested instantiations of a generic type from another module, compiled and run
+    static int NestedGenerics(const std::filesystem::path& runtime);
+
+    // A module with every kind of node, serialized then deserialized : both trees must be equal field by field
+    static int ASTRoundTrip();
+};
+
+#endif //TESTS_H
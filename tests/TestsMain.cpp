@@ -0,0 +1,31 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Tests.h"
+
+// Usage : OnyxTests <test> [runtime directory]
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage : OnyxTests <fresh-build|nested-generics|ast-round-trip> [runtime directory]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string test = argv[1];
+    const std::string runtime = argc > 2 ? argv[2] : "src/IR";
+
+    if (test == "fresh-build") {
+        return Tests::FreshBuild(runtime);
+    }
+    if (test == "nested-generics") {
+        return Tests::NestedGenerics(runtime);
+    }
+    if (test == "ast-round-trip") {
+        return Tests::ASTRoundTrip();
+    }
+    std::cerr << "Unknown test '" << test << "'." << std::endl;
+    return EXIT_FAILURE;
+}
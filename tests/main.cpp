@@ -0,0 +1,51 @@
+//
+// Created by remsc on 17/10/2026.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+
+// Usage : OnyxBench <benchmark> [size], the size defaults to what a benchmark run needs
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage : OnyxBench <lexer|parallel-lexer|ast|flat-ast|overloads|parallel-analysis|module-index|ast-cache|instantiations> [size]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string benchmark = argv[1];
+    const auto size = [&](const size_t fallback) -> size_t {
+        return argc > 2 ? std::stoul(argv[2]) : fallback;
+    };
+
+    if (benchmark == "lexer") {
+        return Benchmark::LexerThroughput(size(64));
+    }
+    if (benchmark == "parallel-lexer") {
+        return Benchmark::ParallelLexer(size(64));
+    }
+    if (benchmark == "ast") {
+        return Benchmark::ASTAllocation(size(16));
+    }
+    if (benchmark == "flat-ast") {
+        return Benchmark::FlatASTPasses(size(16));
+    }
+    if (benchmark == "overloads") {
+        return Benchmark::OverloadResolution(size(10000));
+    }
+    if (benchmark == "parallel-analysis") {
+        return Benchmark::ParallelAnalysis(size(4));
+    }
+    if (benchmark == "module-index") {
+        return Benchmark::ModuleResolution(size(20000));
+    }
+    if (benchmark == "ast-cache") {
+        return Benchmark::ASTCache(size(16));
+    }
+    if (benchmark == "instantiations") {
+        return Benchmark::GenericInstantiation(size(10000));
+    }
+    std::cerr << "Unknown benchmark '" << benchmark << "'." << std::endl;
+    return EXIT_FAILURE;
+}